@@ -0,0 +1,298 @@
+#include <fmt/format.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "aead_vectors.hpp"
+#include "crypto/argon2.hpp"
+#include "crypto/chacha20poly1305.hpp"
+#include "crypto/falcon.hpp"
+#include "crypto/sha3.hpp"
+#include "crypto/sidhp434_compressed.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Measures every lib/crypto primitive and reports, as JSON, the median and minimum time per
+// operation over a number of repetitions, plus bytes per second and TSC cycles per byte for the
+// bulk primitives. The process is pinned to one CPU and every measurement is preceded by a
+// calibration run, which doubles as warmup. The AEAD known answer vectors of tests/crypto are
+// checked first, so a broken backend is not benchmarked.
+//
+// usage: bench_crypto [cpu] [argon2_t_cost] [argon2_m_cost] [argon2_parallelism]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto MIN_REPETITION_TIME = std::chrono::milliseconds(50);
+constexpr size_t REPETITIONS = 11;
+
+const std::vector<size_t> MESSAGE_SIZES = {64, 256, 1024, 1400, 16 * 1024, 64 * 1024};
+
+struct Sample {
+  double cycles_per_op;
+  double ns_per_op;
+};
+
+struct Result {
+  Sample median;
+  Sample min;
+};
+
+bool first_result = true;
+
+uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Keeps the compiler from discarding the outputs of the measured operation.
+void clobber(const void* pointer) { asm volatile("" : : "g"(pointer) : "memory"); }
+
+template <typename Operation>
+Sample run(Operation& operation, size_t iterations) {
+  const auto start = Clock::now();
+  const auto start_cycles = cycles();
+
+  for (size_t i = 0; i < iterations; ++i) {
+    operation();
+  }
+
+  const auto elapsed_cycles = cycles() - start_cycles;
+  const auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+  return {static_cast<double>(elapsed_cycles) / iterations, elapsed / iterations};
+}
+
+template <typename Operation>
+Result measure(Operation&& operation) {
+  // Calibration: grow the iteration count until one repetition is long enough to time.
+  size_t iterations = 1;
+
+  while (run(operation, iterations).ns_per_op * iterations <
+         std::chrono::duration<double, std::nano>(MIN_REPETITION_TIME).count()) {
+    iterations *= 2;
+  }
+
+  std::vector<Sample> samples;
+  samples.reserve(REPETITIONS);
+
+  for (size_t i = 0; i < REPETITIONS; ++i) {
+    samples.push_back(run(operation, iterations));
+  }
+
+  std::sort(samples.begin(), samples.end(),
+            [](const Sample& a, const Sample& b) { return a.ns_per_op < b.ns_per_op; });
+
+  return {samples[samples.size() / 2], samples.front()};
+}
+
+void print_bytes(std::string_view name, size_t size, const Result& result) {
+  fmt::print(
+      "{}    {{\"name\": \"{}\", \"size\": {}, \"ns_per_op\": {:.1f}, \"ns_per_op_min\": {:.1f}, "
+      "\"mib_per_second\": {:.1f}, \"cycles_per_byte\": {:.2f}}}",
+      first_result ? "" : ",\n", name, size, result.median.ns_per_op, result.min.ns_per_op,
+      size / result.median.ns_per_op * 1e9 / (1024 * 1024), result.median.cycles_per_op / size);
+
+  first_result = false;
+}
+
+void print_ops(std::string_view name, const Result& result) {
+  fmt::print(
+      "{}    {{\"name\": \"{}\", \"ns_per_op\": {:.1f}, \"ns_per_op_min\": {:.1f}, "
+      "\"ops_per_second\": {:.1f}}}",
+      first_result ? "" : ",\n", name, result.median.ns_per_op, result.min.ns_per_op,
+      1e9 / result.median.ns_per_op);
+
+  first_result = false;
+}
+
+void pin(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    fmt::print(stderr, "failed to pin to cpu {}, results may be noisy\n", cpu);
+  }
+}
+
+template <typename Aead, typename Vectors>
+void check_aead() {
+  std::vector<uint8_t> ciphertext(Vectors::ciphertext.size());
+  std::vector<uint8_t> tag(Vectors::tag.size());
+
+  Aead::encrypt(ciphertext, tag, Vectors::iv, Vectors::key, Vectors::aad, Vectors::plaintext);
+
+  if (ciphertext != Vectors::ciphertext || tag != Vectors::tag) [[unlikely]] {
+    throw std::runtime_error("known answer test failed");
+  }
+}
+
+template <typename Aead, typename Vectors>
+void bench_aead(std::string_view name) {
+  for (auto size : MESSAGE_SIZES) {
+    std::vector<uint8_t> message(size, 0xA3);
+    std::vector<uint8_t> ciphertext(size);
+    std::vector<uint8_t> tag(Aead::DigestSize);
+
+    print_bytes(fmt::format("{}_encrypt", name), size, measure([&]() {
+                  Aead::encrypt(ciphertext, tag, Vectors::iv, Vectors::key, Vectors::aad, message);
+                  clobber(ciphertext.data());
+                }));
+
+    print_bytes(fmt::format("{}_decrypt", name), size, measure([&]() {
+                  const bool authentic = Aead::decrypt(message, tag, Vectors::iv, Vectors::key,
+                                                       Vectors::aad, ciphertext);
+                  clobber(&authentic);
+                }));
+  }
+}
+
+template <typename Hasher>
+void bench_hash(std::string_view name, size_t digest_size) {
+  std::vector<uint8_t> digest(digest_size);
+
+  for (auto size : MESSAGE_SIZES) {
+    std::vector<uint8_t> message(size, 0xA3);
+
+    print_bytes(name, size, measure([&]() {
+                  Hasher::hash(digest, message);
+                  clobber(digest.data());
+                }));
+  }
+}
+
+void bench_sidh() {
+  using SIDH = crypto::SIDHp434_compressed;
+
+  std::vector<uint8_t> public_key_a(SIDH::PublicKeyLength);
+  std::vector<uint8_t> public_key_b(SIDH::PublicKeyLength);
+  std::vector<uint8_t> secret_key_a(SIDH::SecretKeyALength);
+  std::vector<uint8_t> secret_key_b(SIDH::SecretKeyBLength);
+  std::vector<uint8_t> shared_secret_a(SIDH::SharedSecretLength);
+  std::vector<uint8_t> shared_secret_b(SIDH::SharedSecretLength);
+
+  print_ops("sidhp434_compressed_generate_keypair_a", measure([&]() {
+              SIDH::generate_keypair_A(public_key_a, secret_key_a);
+              clobber(public_key_a.data());
+            }));
+  print_ops("sidhp434_compressed_generate_keypair_b", measure([&]() {
+              SIDH::generate_keypair_B(public_key_b, secret_key_b);
+              clobber(public_key_b.data());
+            }));
+  print_ops("sidhp434_compressed_agree_a", measure([&]() {
+              SIDH::agree_A(shared_secret_a, secret_key_a, public_key_b);
+              clobber(shared_secret_a.data());
+            }));
+  print_ops("sidhp434_compressed_agree_b", measure([&]() {
+              SIDH::agree_B(shared_secret_b, secret_key_b, public_key_a);
+              clobber(shared_secret_b.data());
+            }));
+
+  if (shared_secret_a != shared_secret_b) [[unlikely]] {
+    throw std::runtime_error("sidhp434_compressed agreement mismatch");
+  }
+}
+
+void bench_falcon() {
+  using Falcon = crypto::Falcon512;
+
+  std::vector<uint8_t> public_key(Falcon::PublicKeyLength);
+  std::vector<uint8_t> secret_key(Falcon::SecretKeyLength);
+  std::vector<uint8_t> signature(Falcon::SignatureLength);
+  std::vector<uint8_t> message(32, 0xA3);
+
+  print_ops("falcon512_generate_keypair", measure([&]() {
+              Falcon::generate_keypair(public_key, secret_key);
+              clobber(public_key.data());
+            }));
+  print_ops("falcon512_sign", measure([&]() {
+              Falcon::sign(signature, message, secret_key);
+              clobber(signature.data());
+            }));
+
+  bool verified = true;
+
+  print_ops("falcon512_verify", measure([&]() {
+              verified &= Falcon::verify(signature, message, public_key);
+            }));
+
+  if (!verified) [[unlikely]] {
+    throw std::runtime_error("falcon512 signature rejected");
+  }
+}
+
+void bench_argon2(const crypto::Argon2::Configuration& config) {
+  constexpr std::string_view password = "correct horse battery staple";
+
+  std::string encoded;
+
+  print_ops("argon2id_hash", measure([&]() {
+              encoded = crypto::Argon2::hash(password, crypto::Argon2::Type::id, config);
+            }));
+
+  bool verified = true;
+
+  print_ops("argon2id_verify", measure([&]() {
+              verified &= crypto::Argon2::verify(encoded, password, crypto::Argon2::Type::id);
+            }));
+
+  if (!verified) [[unlikely]] {
+    throw std::runtime_error("argon2id hash rejected");
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  auto argument = [argc, argv](int index, size_t value) {
+    return index < argc ? std::stoull(argv[index]) : value;
+  };
+
+  const int cpu = static_cast<int>(argument(1, 0));
+
+  // Same parameters as used for sign up by default.
+  const crypto::Argon2::Configuration argon2_config{
+      .t_cost = static_cast<uint32_t>(argument(2, 3)),
+      .m_cost = static_cast<uint32_t>(argument(3, 1 << 12)),
+      .parallelism = static_cast<uint32_t>(argument(4, 1)),
+      .saltlen = 8,
+      .hashlen = 32};
+
+  pin(cpu);
+
+  check_aead<crypto::ChaCha20Poly1305, vectors::chacha20poly1305>();
+  check_aead<crypto::XChaCha20Poly1305, vectors::xchacha20poly1305>();
+
+  fmt::print("{{\n  \"benchmark\": \"crypto\",\n  \"cpu\": {},\n", cpu);
+  fmt::print("  \"argon2\": {{\"t_cost\": {}, \"m_cost\": {}, \"parallelism\": {}}},\n",
+             argon2_config.t_cost, argon2_config.m_cost, argon2_config.parallelism);
+  fmt::print("  \"results\": [\n");
+
+  bench_aead<crypto::ChaCha20Poly1305, vectors::chacha20poly1305>("chacha20poly1305");
+  bench_aead<crypto::XChaCha20Poly1305, vectors::xchacha20poly1305>("xchacha20poly1305");
+
+  bench_hash<crypto::SHA3_256>("sha3_256", crypto::SHA3_256::DigestSize);
+  bench_hash<crypto::SHA3_384>("sha3_384", crypto::SHA3_384::DigestSize);
+  bench_hash<crypto::SHA3_512>("sha3_512", crypto::SHA3_512::DigestSize);
+  bench_hash<crypto::SHAKE128>("shake128", 32);
+  bench_hash<crypto::SHAKE256>("shake256", 64);
+
+  bench_sidh();
+  bench_falcon();
+  bench_argon2(argon2_config);
+
+  fmt::print("\n  ]\n}}\n");
+
+  return 0;
+}
@@ -0,0 +1,278 @@
+#include <fmt/format.h>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crypto/sidhp434_compressed.hpp"
+#include "protocol/connection.hpp"
+#include "protocol/detail/connection/api/types/connection_id.hpp"
+#include "protocol/server.hpp"
+
+// Reports the heap bytes a protocol::Server holds per idle established connection, which is the
+// fixed per-connection cost of the server: the connection with its keys, replay window and queues,
+// and the bookkeeping of the server for it. The clients handshake over loopback from a child
+// process, forked before any thread is started, so that only the server side is counted.
+//
+// Every client has a socket of its own, the file descriptor limit is raised as far as allowed.
+// Rounds add clients up to their count rather than replace them, as the ids of closed connections
+// are reused only after a while, and the counts are capped at the number of connection ids.
+//
+// usage: bench_connection_footprint [num_connections...]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto PHASE_TIMEOUT = std::chrono::seconds(120);
+
+constexpr size_t MAX_CONNECTIONS =
+    size_t{std::numeric_limits<protocol::detail::ConnectionID>::max()} + 1;
+
+// Summed over the arenas of every thread, including the blocks large enough to be mapped.
+size_t heap_in_use() {
+  const auto info = mallinfo2();
+
+  return info.uordblks + info.hblkhd;
+}
+
+// Polls until the value of get reaches target, returns false on timeout.
+template <typename Get>
+bool wait_for(Get&& get, size_t target) {
+  const auto deadline = Clock::now() + PHASE_TIMEOUT;
+
+  while (get() != target) {
+    if (Clock::now() > deadline) [[unlikely]] {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  return true;
+}
+
+void raise_file_limit() {
+  rlimit limit{};
+  getrlimit(RLIMIT_NOFILE, &limit);
+
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+}
+
+size_t num_threads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+// Runs in the child process. Reads a number of connections from commands, adds clients until
+// there are as many, and writes back how many got established in total. Exits on 0 or when the
+// pipe is closed.
+void run_clients(int commands, int replies, asio::ip::udp::endpoint server_endpoint,
+                 const std::vector<uint8_t>& public_key) {
+  asio::io_context io_context;
+  auto work_guard = asio::make_work_guard(io_context);
+
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < num_threads(); ++i) {
+    threads.emplace_back([&io_context]() { io_context.run(); });
+  }
+
+  std::vector<std::shared_ptr<protocol::Connection>> clients;
+  std::vector<std::shared_ptr<protocol::Connection::StateChangedEvent::Subscription>>
+      subscriptions;
+  std::atomic<size_t> established = 0;
+
+  size_t num_connections;
+
+  while (read(commands, &num_connections, sizeof(num_connections)) == sizeof(num_connections) &&
+         num_connections != 0) {
+    while (clients.size() < num_connections) {
+      auto& client = clients.emplace_back(std::make_shared<protocol::Connection>(io_context));
+      subscriptions.push_back(
+          client->state_changed()->subscribe([&established](protocol::Connection::State state) {
+            if (state == protocol::Connection::State::Established) {
+              established.fetch_add(1, std::memory_order_relaxed);
+            }
+          }));
+
+      auto socket = std::make_shared<asio::generic::datagram_protocol::socket>(
+          asio::ip::udp::socket(io_context, {asio::ip::address_v4::loopback(), 0}));
+
+      protocol::Connection::ClientConfiguration config;
+      config.rx_socket = socket;
+      config.tx_socket = socket;
+      config.peer_endpoint = server_endpoint;
+      config.peer_public_key = public_key;
+
+      client->associate(std::move(config));
+    }
+
+    wait_for([&established]() { return established.load(std::memory_order_relaxed); },
+             num_connections);
+
+    const size_t reply = established.load();
+
+    if (write(replies, &reply, sizeof(reply)) != sizeof(reply)) {
+      break;
+    }
+  }
+
+  for (auto& client : clients) {
+    client->abort();
+  }
+
+  work_guard.reset();
+  io_context.stop();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::vector<size_t> counts;
+
+  for (int i = 1; i < argc; ++i) {
+    counts.push_back(std::max<size_t>(1, std::stoull(argv[i])));
+  }
+  if (counts.empty()) {
+    counts = {64, MAX_CONNECTIONS};
+  }
+
+  for (auto& count : counts) {
+    count = std::min(count, MAX_CONNECTIONS);
+  }
+  std::sort(counts.begin(), counts.end());
+  counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+
+  raise_file_limit();
+
+  std::vector<uint8_t> public_key(crypto::SIDHp434_compressed::PublicKeyLength);
+  std::vector<uint8_t> secret_key(crypto::SIDHp434_compressed::SecretKeyBLength);
+
+  crypto::SIDHp434_compressed::generate_keypair_B(public_key, secret_key);
+
+  asio::io_context io_context;
+  protocol::Server server(io_context);
+
+  std::mutex mutex;
+  std::vector<std::shared_ptr<protocol::Connection>> connections;
+  std::atomic<size_t> accepted = 0;
+
+  auto new_connection_subscription = server.new_connection()->subscribe([&]() {
+    std::unique_lock lock(mutex);
+
+    while (server.has_pending_connections()) {
+      connections.push_back(server.next_pending_connection());
+      accepted.fetch_add(1, std::memory_order_relaxed);
+    }
+  });
+
+  protocol::Server::Configuration config;
+  config.backlog = counts.back();
+  config.local_endpoint = {asio::ip::address_v4::loopback(), 0};
+  config.secret_key = std::move(secret_key);
+
+  server.open(std::move(config));
+
+  int commands[2];
+  int replies[2];
+
+  if (pipe(commands) != 0 || pipe(replies) != 0) {
+    fmt::print(stderr, "pipe failed\n");
+    return 1;
+  }
+
+  const pid_t child = fork();
+
+  if (child < 0) {
+    fmt::print(stderr, "fork failed\n");
+    return 1;
+  }
+
+  if (child == 0) {
+    close(commands[1]);
+    close(replies[0]);
+
+    run_clients(commands[0], replies[1], server.local_endpoint(), public_key);
+
+    _exit(0);
+  }
+
+  close(commands[0]);
+  close(replies[1]);
+
+  auto work_guard = asio::make_work_guard(io_context);
+
+  std::vector<std::thread> threads;
+
+  for (size_t i = 0; i < num_threads(); ++i) {
+    threads.emplace_back([&io_context]() { io_context.run(); });
+  }
+
+  fmt::print("{{\n  \"benchmark\": \"connection_footprint\",\n  \"results\": [\n");
+
+  const auto before = heap_in_use();
+
+  for (size_t i = 0; i < counts.size(); ++i) {
+    size_t established = 0;
+
+    if (write(commands[1], &counts[i], sizeof(size_t)) != sizeof(size_t) ||
+        read(replies[0], &established, sizeof(established)) != sizeof(established)) {
+      fmt::print(stderr, "client process failed\n");
+      break;
+    }
+
+    const bool completed =
+        established == counts[i] &&
+        wait_for([&accepted]() { return accepted.load(std::memory_order_relaxed); }, counts[i]);
+
+    const auto after = heap_in_use();
+    const auto num_connections = std::max<size_t>(1, accepted.load());
+    const auto per_connection =
+        static_cast<double>(after - before) / static_cast<double>(num_connections);
+
+    fmt::print(
+        "    {{\"completed\": {}, \"connections\": {}, \"heap_bytes\": {}, "
+        "\"bytes_per_connection\": {:.1f}}}{}\n",
+        completed, accepted.load(), after - before, per_connection,
+        i + 1 == counts.size() ? "" : ",");
+  }
+
+  fmt::print("  ]\n}}\n");
+
+  close(commands[1]);
+  waitpid(child, nullptr, 0);
+
+  {
+    std::unique_lock lock(mutex);
+
+    for (auto& connection : connections) {
+      connection->abort();
+    }
+    connections.clear();
+  }
+  server.close();
+
+  work_guard.reset();
+  io_context.stop();
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  return 0;
+}
@@ -0,0 +1,389 @@
+#include <fmt/format.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "crypto/sidhp434_compressed.hpp"
+#include "protocol/connection.hpp"
+#include "protocol/server.hpp"
+#include "protocol/stream.hpp"
+
+// Stands up a protocol::Server and a number of protocol::Connection clients over loopback in one
+// process and reports, as JSON:
+//  - handshake: time until every client is Established,
+//  - single_stream: bulk throughput of one client on one stream,
+//  - many_streams: small message rate of every client spread over several streams,
+//  - latency: round trip percentiles of a ping-pong on one stream,
+// together with the process CPU time spent per transferred GB. A non zero loss or delay impairs
+// both directions of every connection, with a fixed seed so that runs are comparable.
+//
+// usage: bench_transport [num_clients] [num_threads] [single_stream_mib] [num_small_messages]
+//                        [loss_permille] [delay_ms]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto PHASE_TIMEOUT = std::chrono::seconds(60);
+
+constexpr size_t BULK_MESSAGE_SIZE = 16 * 1024;
+constexpr size_t LATENCY_SAMPLES = 10'000;
+constexpr size_t NUM_STREAMS = 16;
+constexpr size_t SMALL_MESSAGE_SIZE = 64;
+
+// First byte of every message, tells the server what to do with it.
+enum Kind : uint8_t { Sink, Echo };
+
+struct Counters {
+  std::atomic<size_t> bytes;
+  std::atomic<size_t> messages;
+};
+
+struct Peer {
+  std::shared_ptr<protocol::Connection> connection;
+  std::shared_ptr<protocol::Connection::ReadyReadEvent::Subscription> ready_read_subscription;
+  std::shared_ptr<protocol::Connection::StateChangedEvent::Subscription>
+      state_changed_subscription;
+};
+
+double cpu_seconds() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+
+  auto seconds = [](const timeval& time) { return time.tv_sec + time.tv_usec / 1e6; };
+
+  return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+}
+
+double seconds_since(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double per_gb(double cpu, size_t bytes) { return bytes == 0 ? 0.0 : cpu / (bytes / 1e9); }
+
+// Polls until the counter reaches target, returns false on timeout.
+bool wait_for(const std::atomic<size_t>& counter, size_t target) {
+  const auto deadline = Clock::now() + PHASE_TIMEOUT;
+
+  while (counter.load(std::memory_order_relaxed) < target) {
+    if (Clock::now() > deadline) [[unlikely]] {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  return true;
+}
+
+std::vector<uint8_t> make_message(Kind kind, size_t size) {
+  std::vector<uint8_t> message(size);
+  message[0] = kind;
+
+  return message;
+}
+
+class Bench {
+ public:
+  Bench(size_t num_clients, size_t num_threads,
+        std::optional<protocol::Connection::NetworkImpairment> impairment)
+      : num_clients_(num_clients),
+        impairment_(std::move(impairment)),
+        work_guard_(asio::make_work_guard(io_context_)) {
+    for (size_t i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this]() { io_context_.run(); });
+    }
+  }
+
+  ~Bench() {
+    for (auto& client : clients_) {
+      client.connection->abort();
+    }
+    server_.close();
+
+    work_guard_.reset();
+    io_context_.stop();
+
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void open() {
+    std::vector<uint8_t> secret_key(crypto::SIDHp434_compressed::SecretKeyBLength);
+    public_key_.resize(crypto::SIDHp434_compressed::PublicKeyLength);
+
+    crypto::SIDHp434_compressed::generate_keypair_B(public_key_, secret_key);
+
+    new_connection_subscription_ =
+        server_.new_connection()->subscribe([this]() { new_connection_handler(); });
+
+    protocol::Server::Configuration config;
+    config.backlog = num_clients_;
+    config.local_endpoint = {asio::ip::address_v4::loopback(), 0};
+    config.network_impairment = impairment_;
+    config.secret_key = std::move(secret_key);
+
+    server_.open(std::move(config));
+  }
+
+  void handshake() {
+    std::atomic<size_t> established = 0;
+
+    auto start = Clock::now();
+
+    for (size_t i = 0; i < num_clients_; ++i) {
+      auto& client = clients_.emplace_back();
+      client.connection = std::make_shared<protocol::Connection>(io_context_);
+      client.state_changed_subscription = client.connection->state_changed()->subscribe(
+          [&established](protocol::Connection::State state) {
+            if (state == protocol::Connection::State::Established) {
+              established.fetch_add(1, std::memory_order_relaxed);
+            }
+          });
+
+      auto socket = std::make_shared<asio::generic::datagram_protocol::socket>(
+          asio::ip::udp::socket(io_context_, {asio::ip::address_v4::loopback(), 0}));
+
+      protocol::Connection::ClientConfiguration config;
+      config.rx_socket = socket;
+      config.tx_socket = socket;
+      config.network_impairment = impairment_;
+      config.peer_endpoint = server_.local_endpoint();
+      config.peer_public_key = public_key_;
+
+      client.connection->associate(std::move(config));
+    }
+
+    const bool completed = wait_for(established, num_clients_);
+    const double seconds = seconds_since(start);
+
+    for (auto& client : clients_) {
+      client.state_changed_subscription.reset();
+    }
+
+    fmt::print(
+        "  \"handshake\": {{\"completed\": {}, \"connections\": {}, \"seconds\": {:.6f}, "
+        "\"per_second\": {:.1f}}},\n",
+        completed, established.load(), seconds, established.load() / seconds);
+  }
+
+  void single_stream(size_t total_bytes) {
+    const size_t num_messages = std::max<size_t>(1, total_bytes / BULK_MESSAGE_SIZE);
+    const size_t bytes = num_messages * BULK_MESSAGE_SIZE;
+
+    const size_t target = counters_.bytes.load() + bytes;
+    const double cpu_start = cpu_seconds();
+    const auto start = Clock::now();
+
+    auto& stream = (*clients_.front().connection)[0];
+
+    for (size_t i = 0; i < num_messages; ++i) {
+      stream.write(make_message(Sink, BULK_MESSAGE_SIZE));
+    }
+
+    const bool completed = wait_for(counters_.bytes, target);
+    const double seconds = seconds_since(start);
+    const double cpu = cpu_seconds() - cpu_start;
+
+    fmt::print(
+        "  \"single_stream\": {{\"completed\": {}, \"bytes\": {}, \"message_size\": {}, "
+        "\"seconds\": {:.6f}, \"mib_per_second\": {:.1f}, \"cpu_seconds_per_gb\": {:.3f}}},\n",
+        completed, bytes, BULK_MESSAGE_SIZE, seconds, bytes / seconds / (1024 * 1024),
+        per_gb(cpu, bytes));
+  }
+
+  void many_streams(size_t num_messages) {
+    const size_t per_client = std::max<size_t>(1, num_messages / clients_.size());
+    const size_t total = per_client * clients_.size();
+    const size_t bytes = total * SMALL_MESSAGE_SIZE;
+
+    const size_t target = counters_.messages.load() + total;
+    const double cpu_start = cpu_seconds();
+    const auto start = Clock::now();
+
+    for (size_t i = 0; i < per_client; ++i) {
+      for (auto& client : clients_) {
+        (*client.connection)[i % NUM_STREAMS].write(make_message(Sink, SMALL_MESSAGE_SIZE));
+      }
+    }
+
+    const bool completed = wait_for(counters_.messages, target);
+    const double seconds = seconds_since(start);
+    const double cpu = cpu_seconds() - cpu_start;
+
+    fmt::print(
+        "  \"many_streams\": {{\"completed\": {}, \"messages\": {}, \"streams\": {}, "
+        "\"message_size\": {}, \"seconds\": {:.6f}, \"messages_per_second\": {:.1f}, "
+        "\"cpu_seconds_per_gb\": {:.3f}}},\n",
+        completed, total, NUM_STREAMS * clients_.size(), SMALL_MESSAGE_SIZE, seconds,
+        total / seconds, per_gb(cpu, bytes));
+  }
+
+  void latency() {
+    auto& client = clients_.front();
+
+    std::vector<double> samples;
+    samples.reserve(LATENCY_SAMPLES);
+
+    std::promise<void> done;
+    auto future = done.get_future();
+
+    auto ping = [&client]() {
+      auto message = make_message(Echo, SMALL_MESSAGE_SIZE);
+      auto now = Clock::now().time_since_epoch().count();
+      std::memcpy(message.data() + 1, &now, sizeof(now));
+
+      (*client.connection)[0].write(std::move(message));
+    };
+
+    client.ready_read_subscription =
+        client.connection->ready_read()->subscribe([&](size_t stream_identifier) {
+          auto& stream = (*client.connection)[stream_identifier];
+
+          while (auto message = stream.read()) {
+            Clock::rep sent;
+            std::memcpy(&sent, message->data() + 1, sizeof(sent));
+
+            samples.push_back(std::chrono::duration<double, std::micro>(
+                                  Clock::now().time_since_epoch() - Clock::duration(sent))
+                                  .count());
+
+            if (samples.size() == LATENCY_SAMPLES) {
+              done.set_value();
+              return;
+            }
+            ping();
+          }
+        });
+
+    ping();
+
+    const bool completed = future.wait_for(PHASE_TIMEOUT) == std::future_status::ready;
+
+    // The handler may still be running on the strand when the phase timed out.
+    std::promise<void> unsubscribed;
+    client.connection->dispatch([&]() {
+      client.ready_read_subscription.reset();
+      unsubscribed.set_value();
+    });
+    unsubscribed.get_future().wait();
+
+    std::sort(samples.begin(), samples.end());
+
+    auto percentile = [&samples](double p) {
+      return samples.empty() ? 0.0 : samples[static_cast<size_t>(p * (samples.size() - 1))];
+    };
+
+    fmt::print(
+        "  \"latency\": {{\"completed\": {}, \"samples\": {}, \"message_size\": {}, "
+        "\"rtt_p50_us\": {:.1f}, \"rtt_p99_us\": {:.1f}, \"rtt_p999_us\": {:.1f}}}\n",
+        completed, samples.size(), SMALL_MESSAGE_SIZE, percentile(0.5), percentile(0.99),
+        percentile(0.999));
+  }
+
+ private:
+  void new_connection_handler() {
+    std::unique_lock lock(mutex_);
+
+    while (server_.has_pending_connections()) {
+      auto& peer = peers_.emplace_back();
+      peer.connection = server_.next_pending_connection();
+      peer.ready_read_subscription = peer.connection->ready_read()->subscribe(
+          [this, connection = peer.connection.get()](size_t stream_identifier) {
+            sink(*connection, stream_identifier);
+          });
+    }
+  }
+
+  // Runs on the connection strand.
+  void sink(protocol::Connection& connection, size_t stream_identifier) {
+    auto& stream = connection[stream_identifier];
+
+    while (auto message = stream.read()) {
+      const size_t size = message->size();
+
+      if ((*message)[0] == Echo) {
+        stream.write(std::move(*message));
+      }
+
+      counters_.bytes.fetch_add(size, std::memory_order_relaxed);
+      counters_.messages.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  const size_t num_clients_;
+  const std::optional<protocol::Connection::NetworkImpairment> impairment_;
+
+  asio::io_context io_context_;
+  asio::executor_work_guard<asio::io_context::executor_type> work_guard_;
+  std::vector<std::thread> threads_;
+
+  std::vector<uint8_t> public_key_;
+
+  protocol::Server server_{io_context_};
+  std::shared_ptr<protocol::Server::NewConnectionEvent::Subscription>
+      new_connection_subscription_;
+
+  std::mutex mutex_;
+  std::vector<Peer> peers_;
+  std::vector<Peer> clients_;
+
+  Counters counters_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  auto argument = [argc, argv](int index, size_t value) {
+    return index < argc ? std::stoull(argv[index]) : value;
+  };
+
+  const size_t num_clients = std::max<size_t>(1, argument(1, 64));
+  const size_t num_threads =
+      std::max<size_t>(1, argument(2, std::max(1u, std::thread::hardware_concurrency())));
+  const size_t single_stream_mib = argument(3, 256);
+  const size_t num_small_messages = argument(4, 1'000'000);
+  const size_t loss_permille = argument(5, 0);
+  const size_t delay_ms = argument(6, 0);
+
+  std::optional<protocol::Connection::NetworkImpairment> impairment;
+
+  if (loss_permille != 0 || delay_ms != 0) {
+    impairment.emplace();
+    impairment->delay = std::chrono::milliseconds(delay_ms);
+    impairment->loss = loss_permille / 1000.0;
+    impairment->seed = 1;
+  }
+
+  fmt::print("{{\n  \"benchmark\": \"transport\",\n");
+  fmt::print("  \"clients\": {},\n  \"threads\": {},\n", num_clients, num_threads);
+  fmt::print("  \"loss_permille\": {},\n  \"delay_ms\": {},\n", loss_permille, delay_ms);
+
+  {
+    Bench bench(num_clients, num_threads, std::move(impairment));
+
+    bench.open();
+    bench.handshake();
+    bench.single_stream(single_stream_mib * 1024 * 1024);
+    bench.many_streams(num_small_messages);
+    bench.latency();
+  }
+
+  fmt::print("}}\n");
+
+  return 0;
+}
@@ -1,3 +1,13 @@
+#include <asio/associated_cancellation_slot.hpp>
+#include <asio/associated_executor.hpp>
+#include <asio/async_result.hpp>
+#include <asio/post.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/use_awaitable.hpp>
+#include <algorithm>
+#include <atomic>
+#include <span>
+
 #include "client_p.hpp"
 #include "detail/api/structures/event.hpp"
 #include "detail/api/structures/exception.hpp"
@@ -10,6 +20,87 @@ namespace communication {
 
 using namespace detail;
 
+namespace {
+
+// Index into ClientPrivate::request_stream_loads, request streams are numbered consecutively.
+std::optional<size_t> request_stream_index(size_t stream_identifier) {
+  if (stream_identifier < Client::FIRST_ORDERED_REQUEST_STREAM ||
+      stream_identifier >= Client::FIRST_UNORDERED_REQUEST_STREAM + Client::REQUEST_STREAMS) {
+    return std::nullopt;
+  }
+
+  return stream_identifier - Client::FIRST_ORDERED_REQUEST_STREAM;
+}
+
+// Completion of a request awaited through Client::request. The response, an exception, the
+// timeout and cancellation race for it: whichever comes first completes the handler on its own
+// executor, the others find it already completed.
+template <typename Handler>
+class RequestOperation : public std::enable_shared_from_this<RequestOperation<Handler>> {
+ public:
+  explicit RequestOperation(Handler &&handler)
+      : handler_(std::move(handler)),
+        executor_(asio::get_associated_executor(*handler_)),
+        slot_(asio::get_associated_cancellation_slot(*handler_)),
+        timer_(executor_),
+        completed_(false) {}
+
+  void complete(std::exception_ptr exception, Payload data) {
+    if (completed_.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+
+    asio::post(executor_, [self = this->shared_from_this(), exception,
+                           data = std::move(data)]() mutable {
+      self->timer_.cancel();
+
+      if (self->slot_.is_connected()) {
+        self->slot_.clear();
+      }
+
+      auto handler = std::move(*self->handler_);
+      self->handler_.reset();
+
+      std::move(handler)(exception, std::move(data));
+    });
+  }
+
+  void start(std::optional<std::chrono::steady_clock::duration> timeout) {
+    if (slot_.is_connected()) {
+      slot_.assign([weak_self = this->weak_from_this()](asio::cancellation_type) {
+        if (auto self = weak_self.lock()) {
+          self->complete(
+              std::make_exception_ptr(asio::system_error(asio::error::operation_aborted)), {});
+        }
+      });
+    }
+
+    if (timeout.has_value()) {
+      timer_.expires_after(*timeout);
+      timer_.async_wait([self = this->shared_from_this()](const asio::error_code &error) {
+        if (!error) {
+          self->complete(std::make_exception_ptr(asio::system_error(asio::error::timed_out)), {});
+        }
+      });
+    }
+  }
+
+ private:
+  std::optional<Handler> handler_;
+  asio::associated_executor_t<Handler> executor_;
+  asio::associated_cancellation_slot_t<Handler> slot_;
+  asio::steady_timer timer_;
+  std::atomic<bool> completed_;
+};
+
+}  // namespace
+
+RequestException::RequestException(size_t code)
+    : std::runtime_error("request failed with exception code " + std::to_string(code)),
+      code_(code) {}
+
+size_t RequestException::code() const { return code_; }
+
 Client::Client()
     : Base(std::static_pointer_cast<BasePrivate>(std::make_shared<ClientPrivate>())),
       impl_(static_cast<ClientPrivate *>(Base::impl_.get())) {}
@@ -22,7 +113,7 @@ bool Client::has_pending_events() const {
   return !impl_->pending_events.empty();
 }
 
-std::optional<std::vector<uint8_t>> Client::next_pending_event() {
+std::optional<Payload> Client::next_pending_event() {
   std::unique_lock lock(impl_->mutex);
 
   if (!is_open()) {
@@ -39,9 +130,47 @@ std::optional<std::vector<uint8_t>> Client::next_pending_event() {
   return event;
 }
 
+asio::awaitable<Payload> Client::request(
+    size_t stream_identifier, std::span<const uint8_t> data,
+    std::optional<std::chrono::steady_clock::duration> timeout) {
+  co_return co_await asio::async_initiate<const asio::use_awaitable_t<>,
+                                          void(std::exception_ptr, Payload)>(
+      [this, stream_identifier, data, timeout](auto handler) {
+        auto operation =
+            std::make_shared<RequestOperation<decltype(handler)>>(std::move(handler));
+
+        operation->start(timeout);
+
+        try {
+          send_request(
+              stream_identifier, data,
+              [operation](Payload data) { operation->complete(nullptr, std::move(data)); },
+              [operation](size_t code) {
+                operation->complete(std::make_exception_ptr(RequestException(code)), {});
+              });
+        } catch (...) {
+          operation->complete(std::current_exception(), {});
+        }
+      },
+      asio::use_awaitable);
+}
+
+asio::awaitable<Payload> Client::request(
+    std::span<const uint8_t> data, std::optional<std::chrono::steady_clock::duration> timeout,
+    Delivery delivery) {
+  size_t stream_identifier;
+
+  {
+    std::unique_lock lock(impl_->mutex);
+
+    stream_identifier = impl_->choose_request_stream(delivery);
+  }
+
+  return request(stream_identifier, data, timeout);
+}
+
 void Client::send_request(size_t stream_identifier, std::span<const uint8_t> data,
-                          const ResponseCallback &on_response,
-                          const ExceptionCallback &on_exception) {
+                          ResponseCallback on_response, ExceptionCallback on_exception) {
   if (on_response == nullptr) {
     throw std::runtime_error("on_response is null");
   }
@@ -52,37 +181,70 @@ void Client::send_request(size_t stream_identifier, std::span<const uint8_t> dat
     throw std::runtime_error("is not open");
   }
 
+  auto buffer = ClientPrivate::build_request(data);
+
   if (impl_->can_send_request()) {
-    impl_->send_request(stream_identifier, data, on_response, on_exception);
+    impl_->send_request(stream_identifier, std::move(buffer), std::move(on_response),
+                        std::move(on_exception));
   } else {
-    impl_->queue_up_request(stream_identifier, data, on_response, on_exception);
+    impl_->queue_up_request(stream_identifier, std::move(buffer), std::move(on_response),
+                            std::move(on_exception));
   }
 }
 
+void Client::send_request(std::span<const uint8_t> data, ResponseCallback on_response,
+                          ExceptionCallback on_exception, Delivery delivery) {
+  std::unique_lock lock(impl_->mutex);
+
+  send_request(impl_->choose_request_stream(delivery), data, std::move(on_response),
+               std::move(on_exception));
+}
+
 ClientPrivate::ClientPrivate() = default;
 
 ClientPrivate::~ClientPrivate() = default;
 
+std::vector<uint8_t> ClientPrivate::build_request(std::span<const uint8_t> data) {
+  auto buffer = build_message(
+      MessageType::Request,
+      serialization::BufferBuilder<Request>{}.set_data_size(data.size()).buffer_size());
+
+  Request request(Message(buffer).data());
+
+  utils::span::copy<uint8_t>(request.data(), data);
+
+  return buffer;
+}
+
 bool ClientPrivate::can_send_request() const {
   return unresponded_requests.size() <= std::numeric_limits<RequestIdentifier>::max();
 }
 
+size_t ClientPrivate::choose_request_stream(Client::Delivery delivery) const {
+  const size_t first = (delivery == Client::Delivery::Ordered)
+                           ? 0
+                           : Client::FIRST_UNORDERED_REQUEST_STREAM -
+                                 Client::FIRST_ORDERED_REQUEST_STREAM;
+
+  auto loads = std::span(request_stream_loads).subspan(first, Client::REQUEST_STREAMS);
+
+  return Client::FIRST_ORDERED_REQUEST_STREAM + first +
+         static_cast<size_t>(std::min_element(loads.begin(), loads.end()) - loads.begin());
+}
+
 template <>
-void ClientPrivate::handle(Event event) {
+void ClientPrivate::handle(Event event, std::vector<uint8_t> &&buffer) {
   if (!event.validate()) {
     return;
   }
 
-  std::vector<uint8_t> data(event.data().size());
-  std::memcpy(data.data(), event.data().data(), data.size());
-
-  pending_events.push_back(std::move(data));
+  pending_events.emplace_back(std::move(buffer), event.data());
 
   new_event_event->emit();
 }
 
 template <>
-void ClientPrivate::handle(Exception exception) {
+void ClientPrivate::handle(Exception exception, [[maybe_unused]] std::vector<uint8_t> &&buffer) {
   if (!exception.validate()) {
     return;
   }
@@ -93,17 +255,23 @@ void ClientPrivate::handle(Exception exception) {
     return;
   }
 
-  const auto &callback = std::get<Client::ExceptionCallback>(unresponded_requests_iterator->second);
+  // The callback may send further requests, which must not invalidate the iterator under it.
+  auto [request_stream_identifier, on_response, on_exception] =
+      std::move(unresponded_requests_iterator->second);
+
+  unresponded_requests.erase(unresponded_requests_iterator);
+
+  unload_request_stream(request_stream_identifier);
 
-  if (callback != nullptr) {
-    callback(exception.code());
+  if (on_exception != nullptr) {
+    on_exception(exception.code());
   }
 
-  unresponded_requests.erase(unresponded_requests_iterator);
+  send_next_request();
 }
 
 template <>
-void ClientPrivate::handle(Response response) {
+void ClientPrivate::handle(Response response, std::vector<uint8_t> &&buffer) {
   if (!response.validate()) {
     return;
   }
@@ -114,61 +282,77 @@ void ClientPrivate::handle(Response response) {
     return;
   }
 
-  const auto &callback = std::get<Client::ResponseCallback>(unresponded_requests_iterator->second);
+  // The callback may send further requests, which must not invalidate the iterator under it.
+  auto [request_stream_identifier, on_response, on_exception] =
+      std::move(unresponded_requests_iterator->second);
 
-  ASSERT(callback != nullptr);
+  unresponded_requests.erase(unresponded_requests_iterator);
 
-  std::vector<uint8_t> data(response.data().size());
-  std::memcpy(data.data(), response.data().data(), data.size());
+  unload_request_stream(request_stream_identifier);
 
-  callback(std::move(data));
+  ASSERT(on_response != nullptr);
 
-  unresponded_requests.erase(unresponded_requests_iterator);
+  on_response(Payload(std::move(buffer), response.data()));
 
-  if (!unsent_requests.empty()) {
-    auto tuple = std::move(unsent_requests.front());
-    unsent_requests.pop_front();
+  send_next_request();
+}
 
-    std::apply([this](auto &&...args) { send_request(std::forward<decltype(args)>(args)...); },
-               tuple);
-  }
+void ClientPrivate::queue_up_request(size_t stream_identifier, std::vector<uint8_t> &&buffer,
+                                     Client::ResponseCallback &&on_response,
+                                     Client::ExceptionCallback &&on_exception) {
+  unsent_requests.emplace_back(stream_identifier, std::move(buffer), std::move(on_response),
+                               std::move(on_exception));
 }
 
-void ClientPrivate::queue_up_request(size_t stream_identifier, std::span<const uint8_t> data,
-                                     const Client::ResponseCallback &on_response,
-                                     const Client::ExceptionCallback &on_exception) {
-  std::vector<uint8_t> data_copy(data.size());
-  std::memcpy(data_copy.data(), data.data(), data_copy.size());
+void ClientPrivate::send_next_request() {
+  if (unsent_requests.empty() || !can_send_request()) {
+    return;
+  }
+
+  auto tuple = std::move(unsent_requests.front());
+  unsent_requests.pop_front();
 
-  unsent_requests.emplace_back(stream_identifier, std::move(data_copy), on_response, on_exception);
+  std::apply([this](auto &&...args) { send_request(std::forward<decltype(args)>(args)...); },
+             std::move(tuple));
 }
 
-void ClientPrivate::send_request(size_t stream_identifier, std::span<const uint8_t> data,
-                                 const Client::ResponseCallback &on_response,
-                                 const Client::ExceptionCallback &on_exception) {
-  auto buffer = serialization::BufferBuilder<Request>{}.set_data_size(data.size()).build();
+void ClientPrivate::send_request(size_t stream_identifier, std::vector<uint8_t> &&buffer,
+                                 Client::ResponseCallback &&on_response,
+                                 Client::ExceptionCallback &&on_exception) {
+  Request request(Message(buffer).data());
 
-  Request request(buffer);
+  const size_t request_identifier = next_request_id++;
 
-  request.id() = next_request_id++;
+  request.id() = request_identifier;
 
-  utils::span::copy<uint8_t>(request.data(), data);
+  send_message(stream_identifier, std::move(buffer));
 
-  send_message(stream_identifier, MessageType::Request, std::move(buffer));
+  unresponded_requests.emplace(request_identifier,
+                               std::make_tuple(stream_identifier, std::move(on_response),
+                                               std::move(on_exception)));
 
-  unresponded_requests.emplace(request.id(), std::make_tuple(on_response, on_exception));
+  if (auto index = request_stream_index(stream_identifier)) {
+    ++request_stream_loads[*index];
+  }
+}
+
+void ClientPrivate::unload_request_stream(size_t stream_identifier) {
+  if (auto index = request_stream_index(stream_identifier)) {
+    --request_stream_loads[*index];
+  }
 }
 
-void ClientPrivate::message_handler([[maybe_unused]] size_t stream_identifier, Message message) {
+void ClientPrivate::message_handler([[maybe_unused]] size_t stream_identifier, Message message,
+                                    std::vector<uint8_t> &&buffer) {
   switch (message.type()) {
     case MessageType::Event:
-      handle(Event(message.data()));
+      handle(Event(message.data()), std::move(buffer));
       break;
     case MessageType::Exception:
-      handle(Exception(message.data()));
+      handle(Exception(message.data()), std::move(buffer));
       break;
     case MessageType::Response:
-      handle(Response(message.data()));
+      handle(Response(message.data()), std::move(buffer));
       break;
     default:
       return;
@@ -1,9 +1,12 @@
 #pragma once
 
-#include <functional>
+#include <asio/awaitable.hpp>
+#include <chrono>
 #include <optional>
+#include <stdexcept>
 
 #include "detail/base.hpp"
+#include "utils/small_function.hpp"
 
 namespace communication {
 
@@ -13,13 +16,29 @@ class ClientPrivate;
 
 }
 
+// Thrown by Client::request when the server answers the request with an exception.
+class RequestException : public std::runtime_error {
+ public:
+  explicit RequestException(size_t code);
+
+  [[nodiscard]] size_t code() const;
+
+ private:
+  size_t code_;
+};
+
 class Client : public detail::Base {
  public:
   using NewEventEvent = utils::Event<>;
 
  public:
-  using ExceptionCallback = std::function<void(size_t /* code */)>;
-  using ResponseCallback = std::function<void(std::vector<uint8_t> /* data */)>;
+  using ExceptionCallback = utils::SmallFunction<void(size_t /* code */)>;
+  using ResponseCallback = utils::SmallFunction<void(Payload /* data */)>;
+
+  // How a request placed on the request streams is handed over to the server. Unordered suits
+  // idempotent requests: they are handled as soon as they arrive, not after earlier requests on
+  // the same stream.
+  enum class Delivery { Ordered, Unordered };
 
  public:
   explicit Client();
@@ -27,11 +46,31 @@ class Client : public detail::Base {
 
   [[nodiscard]] bool has_pending_events() const;
 
-  std::optional<std::vector<uint8_t>> next_pending_event();
+  std::optional<Payload> next_pending_event();
+
+  // Sends a request and resumes with its response, e.g.
+  //   auto response = co_await client.request(0, data, std::chrono::seconds(5));
+  // Throws RequestException when the server answers with an exception, and asio::system_error
+  // with asio::error::timed_out once timeout passes, or with asio::error::operation_aborted when
+  // the awaiting operation is cancelled. An abandoned request is still answered by the server,
+  // its response is dropped.
+  asio::awaitable<Payload> request(
+      size_t stream_identifier, std::span<const uint8_t> data,
+      std::optional<std::chrono::steady_clock::duration> timeout = std::nullopt);
+
+  // As above, on the request stream with the fewest unanswered requests.
+  asio::awaitable<Payload> request(
+      std::span<const uint8_t> data,
+      std::optional<std::chrono::steady_clock::duration> timeout = std::nullopt,
+      Delivery delivery = Delivery::Ordered);
 
   void send_request(size_t stream_identifier, std::span<const uint8_t> data,
-                    const ResponseCallback& on_response,
-                    const ExceptionCallback& on_exception = nullptr);
+                    ResponseCallback on_response, ExceptionCallback on_exception = nullptr);
+
+  // As above, on the request stream with the fewest unanswered requests.
+  void send_request(std::span<const uint8_t> data, ResponseCallback on_response,
+                    ExceptionCallback on_exception = nullptr,
+                    Delivery delivery = Delivery::Ordered);
 
  public:
   [[nodiscard]] std::shared_ptr<NewEventEvent> new_event() const;
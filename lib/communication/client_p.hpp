@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <unordered_map>
 
 #include "client.hpp"
@@ -14,29 +15,42 @@ class ClientPrivate : public detail::BasePrivate {
   explicit ClientPrivate();
   ~ClientPrivate() override;
 
+  // Request message around data, its identifier is only assigned once it is sent.
+  static std::vector<uint8_t> build_request(std::span<const uint8_t> data);
+
   bool can_send_request() const;
 
+  size_t choose_request_stream(Client::Delivery delivery) const;
+
   template <typename T>
-  void handle(T);
+  void handle(T, std::vector<uint8_t> &&buffer);
+
+  void queue_up_request(size_t stream_identifier, std::vector<uint8_t> &&buffer,
+                        Client::ResponseCallback &&on_response,
+                        Client::ExceptionCallback &&on_exception);
+
+  void send_next_request();
 
-  void queue_up_request(size_t stream_identifier, std::span<const uint8_t> data,
-                        const Client::ResponseCallback &on_response,
-                        const Client::ExceptionCallback &on_exception);
+  void send_request(size_t stream_identifier, std::vector<uint8_t> &&buffer,
+                    Client::ResponseCallback &&on_response,
+                    Client::ExceptionCallback &&on_exception);
 
-  void send_request(size_t stream_identifier, std::span<const uint8_t> data,
-                    const Client::ResponseCallback &on_response,
-                    const Client::ExceptionCallback &on_exception);
+  void unload_request_stream(size_t stream_identifier);
 
  public:
-  void message_handler(size_t stream_identifier, Message message) override;
+  void message_handler(size_t stream_identifier, Message message,
+                       std::vector<uint8_t> &&buffer) override;
 
  public:
   std::shared_ptr<Client::NewEventEvent> new_event_event;
 
   size_t next_request_id;
-  std::deque<std::vector<uint8_t>> pending_events;
-  std::unordered_map<size_t, std::tuple<Client::ResponseCallback, Client::ExceptionCallback>>
+  std::deque<Payload> pending_events;
+  std::unordered_map<size_t, std::tuple<size_t /* stream_identifier */, Client::ResponseCallback,
+                                        Client::ExceptionCallback>>
       unresponded_requests;
+  // Unanswered requests per request stream, ordered streams first.
+  std::array<size_t, 2 * Client::REQUEST_STREAMS> request_stream_loads{};
   std::deque<
       std::tuple<size_t, std::vector<uint8_t>, Client::ResponseCallback, Client::ExceptionCallback>>
       unsent_requests;
@@ -4,37 +4,25 @@
 #include "../types/request_identifier.hpp"
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_integer.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace communication {
 
 namespace detail {
 
-class Exception : public serialization::PackedStruct {
+class Exception final : public serialization::PackedLayoutStruct<Exception> {
  public:
-  using PackedStruct::PackedStruct;
-
-  auto& id() { return jmp_ref<id_type>(id_offset()); }
-  auto& code() { return jmp_ref<code_type>(code_offset()); }
-
-  bool validate() override {
-    if (!range_check(id_offset(), sizeof(id_type))) {
-      return false;
-    }
-    if (!range_check(code_offset(), sizeof(code_type))) {
-      return false;
-    }
+  using id_type = serialization::PackedInteger<RequestIdentifier>;
+  using code_type = serialization::PackedInteger<ExceptionCode>;
 
-    return true;
-  }
+  using layout_type = serialization::PackedLayout<serialization::field::Fixed<id_type>,
+                                                  serialization::field::Fixed<code_type>>;
 
  public:
-  using id_type = serialization::PackedInteger<RequestIdentifier>;
-  using code_type = serialization::PackedInteger<ExceptionCode>;
+  using PackedLayoutStruct::PackedLayoutStruct;
 
- private:
-  size_t id_offset() { return 0; }
-  size_t code_offset() { return id_offset() + sizeof(id_type); }
+  auto& id() { return get<0>(); }
+  auto& code() { return get<1>(); }
 };
 
 }  // namespace detail
@@ -50,9 +38,9 @@ class BufferBuilder<Exception, Tags...> {
  public:
   BufferBuilder() = default;
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
-  size_t buffer_size() { return sizeof(Exception::id_type) + sizeof(Exception::code_type); }
+  size_t buffer_size() { return Exception::layout_type::static_size; }
 };
 
 }  // namespace serialization
@@ -3,38 +3,26 @@
 #include "../types/message_type.hpp"
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_enum.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace communication {
 
 namespace detail {
 
-class Message : public serialization::PackedStruct {
+class Message final : public serialization::PackedLayoutStruct<Message> {
  public:
-  using PackedStruct::PackedStruct;
-
-  auto &type() { return jmp_ref<type_type>(type_offset()); }
-  auto data() { return data_type(jmp_ptr<data_type::value_type>(data_offset()), data_size()); }
-
-  bool validate() override {
-    if (!range_check(type_offset(), sizeof(type_type))) {
-      return false;
-    }
-    if (!range_check(data_offset(), data_size())) {
-      return false;
-    }
+  using type_type = serialization::PackedEnum<MessageType>;
+  using data_type = std::span<uint8_t>;
 
-    return true;
-  }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Fixed<type_type>,
+                                  serialization::field::Tail<data_type::value_type>>;
 
  public:
-  using type_type = serialization::PackedEnum<MessageType>;
-  using data_type = std::span<uint8_t>;
+  using PackedLayoutStruct::PackedLayoutStruct;
 
- private:
-  size_t type_offset() { return 0; }
-  size_t data_offset() { return type_offset() + sizeof(type_type); }
-  size_t data_size() { return raw_size() - data_offset(); }
+  auto &type() { return get<0>(); }
+  auto data() { return get<1>(); }
 };
 
 }  // namespace detail
@@ -48,12 +36,12 @@ using namespace communication::detail;
 template <typename... Tags>
 class BufferBuilder<Message, Tags...> {
  public:
-  static constexpr size_t static_size = sizeof(Message::type_type);
+  static constexpr size_t static_size = Message::layout_type::static_size;
 
  public:
   BufferBuilder() : data_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + data_size(); }
 
@@ -1,32 +1,23 @@
 #pragma once
 
 #include "serialization/buffer_builder.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace communication {
 
 namespace detail {
 
-class RawData : public serialization::PackedStruct {
+class RawData final : public serialization::PackedLayoutStruct<RawData> {
  public:
-  using PackedStruct::PackedStruct;
-
-  auto data() { return data_type(jmp_ptr<data_type::value_type>(data_offset()), data_size()); }
-
-  bool validate() override {
-    if (!range_check(data_offset(), data_size())) {
-      return false;
-    }
+  using data_type = std::span<uint8_t>;
 
-    return true;
-  }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Tail<data_type::value_type>>;
 
  public:
-  using data_type = std::span<uint8_t>;
+  using PackedLayoutStruct::PackedLayoutStruct;
 
- private:
-  size_t data_offset() { return 0; }
-  size_t data_size() { return raw_size() - data_offset(); }
+  auto data() { return get<0>(); }
 };
 
 }  // namespace detail
@@ -42,7 +33,7 @@ class BufferBuilder<RawData, Tags...> {
  public:
   BufferBuilder() : data_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return data_size(); }
 
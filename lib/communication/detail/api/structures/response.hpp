@@ -3,38 +3,26 @@
 #include "../types/request_identifier.hpp"
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_integer.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace communication {
 
 namespace detail {
 
-class Response : public serialization::PackedStruct {
+class Response final : public serialization::PackedLayoutStruct<Response> {
  public:
-  using PackedStruct::PackedStruct;
-
-  auto &id() { return jmp_ref<id_type>(id_offset()); }
-  auto data() { return data_type(jmp_ptr<data_type::value_type>(data_offset()), data_size()); }
-
-  bool validate() override {
-    if (!range_check(id_offset(), sizeof(id_type))) {
-      return false;
-    }
-    if (!range_check(data_offset(), data_size())) {
-      return false;
-    }
+  using id_type = serialization::PackedInteger<RequestIdentifier>;
+  using data_type = std::span<uint8_t>;
 
-    return true;
-  }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Fixed<id_type>,
+                                  serialization::field::Tail<data_type::value_type>>;
 
  public:
-  using id_type = serialization::PackedInteger<RequestIdentifier>;
-  using data_type = std::span<uint8_t>;
+  using PackedLayoutStruct::PackedLayoutStruct;
 
- private:
-  size_t id_offset() { return 0; }
-  size_t data_offset() { return id_offset() + sizeof(id_type); }
-  size_t data_size() { return raw_size() - data_offset(); }
+  auto &id() { return get<0>(); }
+  auto data() { return get<1>(); }
 };
 
 }  // namespace detail
@@ -48,12 +36,12 @@ using namespace communication::detail;
 template <typename... Tags>
 class BufferBuilder<Response, Tags...> {
  public:
-  static constexpr size_t static_size = sizeof(Response::id_type);
+  static constexpr size_t static_size = Response::layout_type::static_size;
 
  public:
   BufferBuilder() : data_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + data_size(); }
 
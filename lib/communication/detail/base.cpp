@@ -29,7 +29,7 @@ bool Base::has_pending_raw_data() const {
   return !impl_->pending_raw_data.empty();
 }
 
-std::optional<std::vector<uint8_t>> Base::next_pending_raw_data() {
+std::optional<Payload> Base::next_pending_raw_data() {
   std::unique_lock lock(impl_->mutex);
 
   if (!is_open()) {
@@ -61,13 +61,21 @@ void Base::open(std::shared_ptr<protocol::Connection> connection) {
         }
       });
 
-  while (auto stream_identifier = impl_->connection->readable_stream()) {
-    auto& stream = (*impl_->connection)[*stream_identifier];
+  impl_->prepared_unordered_streams.reset();
 
-    while (stream.is_readable()) {
-      impl_->ready_read_handler(*stream_identifier);
+  impl_->connection->dispatch([weak_impl = impl_->weak_from_this()]() {
+    if (auto impl = weak_impl.lock()) {
+      std::unique_lock lock(impl->mutex);
+
+      if (impl->connection == nullptr) {
+        return;
+      }
+
+      while (auto stream_identifier = impl->connection->readable_stream()) {
+        impl->ready_read_handler(*stream_identifier);
+      }
     }
-  }
+  });
 }
 
 void Base::send_raw_data(size_t stream_identifier, std::span<const uint8_t> data) {
@@ -77,13 +85,15 @@ void Base::send_raw_data(size_t stream_identifier, std::span<const uint8_t> data
     throw std::runtime_error("is not open");
   }
 
-  auto buffer = serialization::BufferBuilder<RawData>{}.set_data_size(data.size()).build();
+  auto buffer = BasePrivate::build_message(
+      MessageType::RawData,
+      serialization::BufferBuilder<RawData>{}.set_data_size(data.size()).buffer_size());
 
-  RawData raw_data(buffer);
+  RawData raw_data(Message(buffer).data());
 
   utils::span::copy<uint8_t>(raw_data.data(), data);
 
-  impl_->send_message(stream_identifier, MessageType::RawData, std::move(buffer));
+  impl_->send_message(stream_identifier, std::move(buffer));
 }
 
 std::shared_ptr<Base::NewRawDataEvent> Base::new_raw_data() const {
@@ -94,50 +104,76 @@ BasePrivate::BasePrivate() : new_raw_data_event(Base::NewRawDataEvent::create())
 
 BasePrivate::~BasePrivate() = default;
 
-void BasePrivate::handle(RawData raw_data) {
+std::vector<uint8_t> BasePrivate::build_message(MessageType type, size_t data_size) {
+  auto buffer = serialization::BufferBuilder<Message>{}.set_data_size(data_size).build();
+
+  Message(buffer).type() = type;
+
+  return buffer;
+}
+
+void BasePrivate::handle(RawData raw_data, std::vector<uint8_t>&& buffer) {
   if (!raw_data.validate()) {
     return;
   }
 
-  std::vector<uint8_t> data(raw_data.data().size());
-  std::memcpy(data.data(), raw_data.data().data(), data.size());
-
-  pending_raw_data.push_back(std::move(data));
+  pending_raw_data.emplace_back(std::move(buffer), raw_data.data());
 
   new_raw_data_event->emit();
 }
 
-void BasePrivate::send_message(size_t stream_identifier, MessageType type,
-                               std::vector<uint8_t>&& data) {
-  switch (type) {
+void BasePrivate::send_message(size_t stream_identifier, std::vector<uint8_t>&& buffer) {
+  [[maybe_unused]] Message message(buffer);
+
+  ASSERT(message.validate());
+
+  switch (message.type()) {
     case MessageType::Event:
-      ASSERT(Event(data).validate());
+      ASSERT(Event(message.data()).validate());
       break;
     case MessageType::Exception:
-      ASSERT(Exception(data).validate());
+      ASSERT(Exception(message.data()).validate());
       break;
     case MessageType::RawData:
-      ASSERT(RawData(data).validate());
+      ASSERT(RawData(message.data()).validate());
       break;
     case MessageType::Request:
-      ASSERT(Request(data).validate());
+      ASSERT(Request(message.data()).validate());
       break;
     case MessageType::Response:
-      ASSERT(Response(data).validate());
+      ASSERT(Response(message.data()).validate());
       break;
   }
 
-  auto buffer = serialization::BufferBuilder<Message>{}.set_data_size(data.size()).build();
-
-  Message message(buffer);
+  ASSERT(connection != nullptr);
 
-  message.type() = type;
+  prepare_stream(stream_identifier);
 
-  utils::span::copy<uint8_t>(message.data(), data);
+  (*connection)[stream_identifier].write(std::move(buffer));
+}
 
+void BasePrivate::send_message(size_t stream_identifier,
+                               std::shared_ptr<const std::vector<uint8_t>> buffer) {
+  ASSERT(buffer != nullptr);
   ASSERT(connection != nullptr);
 
-  (*connection)[stream_identifier].write(buffer);
+  prepare_stream(stream_identifier);
+
+  (*connection)[stream_identifier].write(std::move(buffer));
+}
+
+void BasePrivate::prepare_stream(size_t stream_identifier) {
+  const size_t index = stream_identifier - Base::FIRST_UNORDERED_REQUEST_STREAM;
+
+  if (stream_identifier < Base::FIRST_UNORDERED_REQUEST_STREAM ||
+      index >= Base::REQUEST_STREAMS || prepared_unordered_streams.test(index)) [[likely]] {
+    return;
+  }
+
+  prepared_unordered_streams.set(index);
+
+  (*connection)[stream_identifier].set_reliability_params(
+      true, protocol::Stream::ReliabilityType::Reliable, 0);
 }
 
 void BasePrivate::ready_read_handler(size_t stream_identifier) {
@@ -148,21 +184,23 @@ void BasePrivate::ready_read_handler(size_t stream_identifier) {
   while (auto data = (*connection)[stream_identifier].read()) {
     Message message(*data);
 
-    if (!message.validate()) {
-      continue;
+    if (message.validate()) [[likely]] {
+      BasePrivate::message_handler(stream_identifier, message, std::move(*data));
     }
 
-    BasePrivate::message_handler(stream_identifier, message);
+    // Left over unless a handler kept the message.
+    serialization::BufferPool::release(std::move(*data));
   }
 }
 
-void BasePrivate::message_handler(size_t stream_identifier, Message message) {
+void BasePrivate::message_handler(size_t stream_identifier, Message message,
+                                  std::vector<uint8_t>&& buffer) {
   switch (message.type()) {
     case MessageType::RawData:
-      handle(RawData(message.data()));
+      handle(RawData(message.data()), std::move(buffer));
       break;
     default:
-      message_handler(stream_identifier, message);
+      message_handler(stream_identifier, message, std::move(buffer));
       break;
   }
 }
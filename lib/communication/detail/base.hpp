@@ -5,6 +5,7 @@
 #include <optional>
 #include <span>
 
+#include "payload.hpp"
 #include "utils/event.hpp"
 
 namespace protocol {
@@ -23,6 +24,16 @@ class Base {
  public:
   using NewRawDataEvent = utils::Event<>;
 
+  // Stream layout shared by both ends. Events have a stream of their own. Requests placed
+  // automatically go on one of a pool of ordered streams or, when the order they are handed over
+  // in does not matter, of unordered ones; responses come back on the stream of their request.
+  // A slow request then only holds up the requests that share its stream.
+  static constexpr size_t EVENT_STREAM = 0;
+  static constexpr size_t REQUEST_STREAMS = 8;
+  static constexpr size_t FIRST_ORDERED_REQUEST_STREAM = EVENT_STREAM + 1;
+  static constexpr size_t FIRST_UNORDERED_REQUEST_STREAM =
+      FIRST_ORDERED_REQUEST_STREAM + REQUEST_STREAMS;
+
  public:
   explicit Base(std::shared_ptr<BasePrivate> impl);
   virtual ~Base();
@@ -33,7 +44,7 @@ class Base {
 
   [[nodiscard]] bool has_pending_raw_data() const;
 
-  std::optional<std::vector<uint8_t>> next_pending_raw_data();
+  std::optional<Payload> next_pending_raw_data();
 
   void open(std::shared_ptr<protocol::Connection> connection);
 
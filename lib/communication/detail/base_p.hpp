@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bitset>
 #include <deque>
 #include <mutex>
 #include <span>
@@ -7,6 +8,7 @@
 #include "base.hpp"
 #include "detail/api/structures/message.hpp"
 #include "detail/api/structures/raw_data.hpp"
+#include "detail/payload.hpp"
 #include "protocol/connection.hpp"
 
 namespace communication {
@@ -18,14 +20,24 @@ class BasePrivate : public std::enable_shared_from_this<BasePrivate> {
   explicit BasePrivate();
   virtual ~BasePrivate();
 
-  void handle(RawData raw_data);
+  // Message of the given type with room for data_size bytes of data, which the caller frames in
+  // place, so the application data is copied exactly once on the way out.
+  static std::vector<uint8_t> build_message(MessageType type, size_t data_size);
 
-  void send_message(size_t stream_identifier, MessageType type, std::vector<uint8_t>&& data);
+  void handle(RawData raw_data, std::vector<uint8_t>&& buffer);
+
+  void send_message(size_t stream_identifier, std::vector<uint8_t>&& buffer);
+
+  // The message is shared with other connections and was validated once when it was framed.
+  void send_message(size_t stream_identifier,
+                    std::shared_ptr<const std::vector<uint8_t>> buffer);
 
  public:
   void ready_read_handler(size_t stream_identifier);
 
-  virtual void message_handler(size_t stream_identifier, Message message) = 0;
+  // The message is a view into buffer, handlers keeping its data take the buffer with it.
+  virtual void message_handler(size_t stream_identifier, Message message,
+                               std::vector<uint8_t>&& buffer) = 0;
 
  public:
   std::recursive_mutex mutex;
@@ -33,10 +45,17 @@ class BasePrivate : public std::enable_shared_from_this<BasePrivate> {
   std::shared_ptr<protocol::Connection> connection;
   std::shared_ptr<protocol::Connection::ReadyReadEvent::Subscription> ready_read_subscription;
 
+ private:
+  // Unordered request streams are set up by their first message, so that a connection only
+  // creates the streams it uses.
+  void prepare_stream(size_t stream_identifier);
+
  private:
   std::shared_ptr<Base::NewRawDataEvent> new_raw_data_event;
 
-  std::deque<std::vector<uint8_t>> pending_raw_data;
+  std::deque<Payload> pending_raw_data;
+
+  std::bitset<Base::REQUEST_STREAMS> prepared_unordered_streams;
 
   friend Base;
 };
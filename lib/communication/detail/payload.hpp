@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "serialization/buffer_pool.hpp"
+#include "utils/debug/assert.hpp"
+
+namespace communication {
+
+// Application data of a received message: a view into the reassembled message it came in, which
+// it keeps alive, so the bytes are never copied out of the message. The message buffer goes back
+// to the pool when the payload is destroyed.
+class Payload {
+ public:
+  Payload() = default;
+
+  Payload(std::vector<uint8_t>&& buffer, std::span<const uint8_t> view)
+      : buffer_(std::move(buffer)), view_(view) {
+    ASSERT(view_.empty() || (view_.data() >= buffer_.data() &&
+                             view_.data() + view_.size() <= buffer_.data() + buffer_.size()));
+  }
+
+  Payload(const Payload&) = delete;
+
+  Payload(Payload&& other) noexcept
+      : buffer_(std::move(other.buffer_)), view_(std::exchange(other.view_, {})) {}
+
+  ~Payload() { serialization::BufferPool::release(std::move(buffer_)); }
+
+  Payload& operator=(const Payload&) = delete;
+
+  Payload& operator=(Payload&& other) noexcept {
+    if (this != &other) {
+      serialization::BufferPool::release(std::move(buffer_));
+
+      buffer_ = std::move(other.buffer_);
+      view_ = std::exchange(other.view_, {});
+    }
+
+    return *this;
+  }
+
+  [[nodiscard]] const uint8_t* data() const { return view_.data(); }
+
+  [[nodiscard]] bool empty() const { return view_.empty(); }
+
+  [[nodiscard]] size_t size() const { return view_.size(); }
+
+  [[nodiscard]] auto begin() const { return view_.begin(); }
+
+  [[nodiscard]] auto end() const { return view_.end(); }
+
+  operator std::span<const uint8_t>() const { return view_; }
+
+ private:
+  std::vector<uint8_t> buffer_;
+  std::span<const uint8_t> view_;
+};
+
+}  // namespace communication
@@ -1,6 +1,7 @@
 #include "detail/api/structures/event.hpp"
 #include "detail/api/structures/exception.hpp"
 #include "detail/api/structures/response.hpp"
+#include "serialization/buffer_pool.hpp"
 #include "server_p.hpp"
 #include "utils/debug/assert.hpp"
 #include "utils/span/copy.hpp"
@@ -13,8 +14,55 @@ Server::Server()
     : Base(std::static_pointer_cast<BasePrivate>(std::make_shared<ServerPrivate>())),
       impl_(static_cast<ServerPrivate*>(Base::impl_.get())) {}
 
+Server::EventBuffer::EventBuffer(std::vector<uint8_t>&& buffer) : buffer_(std::move(buffer)) {}
+
+Server::EventBuffer::~EventBuffer() { serialization::BufferPool::release(std::move(buffer_)); }
+
+std::span<uint8_t> Server::EventBuffer::data() { return Event(Message(buffer_).data()).data(); }
+
+Server::SharedEvent Server::EventBuffer::share() && {
+  ASSERT(Event(Message(buffer_).data()).validate());
+
+  return std::make_shared<const std::vector<uint8_t>>(std::move(buffer_));
+}
+
+Server::ResponseBuffer::ResponseBuffer(std::vector<uint8_t>&& buffer)
+    : buffer_(std::move(buffer)) {}
+
+Server::ResponseBuffer::~ResponseBuffer() {
+  serialization::BufferPool::release(std::move(buffer_));
+}
+
+std::span<uint8_t> Server::ResponseBuffer::data() {
+  if (buffer_.empty()) {
+    return {};
+  }
+
+  return Response(Message(buffer_).data()).data();
+}
+
 Server::~Server() = default;
 
+Server::SharedEvent Server::build_event(std::span<const uint8_t> data) {
+  auto event = build_event(data.size());
+
+  utils::span::copy<uint8_t>(event.data(), data);
+
+  return std::move(event).share();
+}
+
+Server::EventBuffer Server::build_event(size_t data_size) {
+  return EventBuffer(BasePrivate::build_message(
+      MessageType::Event,
+      serialization::BufferBuilder<Event>{}.set_data_size(data_size).buffer_size()));
+}
+
+Server::ResponseBuffer Server::build_response(size_t data_size) {
+  return ResponseBuffer(BasePrivate::build_message(
+      MessageType::Response,
+      serialization::BufferBuilder<Response>{}.set_data_size(data_size).buffer_size()));
+}
+
 bool Server::has_pending_requests() const {
   std::unique_lock lock(impl_->mutex);
 
@@ -27,7 +75,7 @@ bool Server::has_pending_requests() const {
 
 size_t Server::max_exception_code() const { return std::numeric_limits<ExceptionCode>::max(); }
 
-std::optional<std::pair<size_t, std::vector<uint8_t>>> Server::next_pending_request() {
+std::optional<std::pair<size_t, Payload>> Server::next_pending_request() {
   std::unique_lock lock(impl_->mutex);
 
   if (!is_open()) {
@@ -53,22 +101,54 @@ void Server::send_event(size_t stream_identifier, std::span<const uint8_t> data)
     throw std::runtime_error("is not open");
   }
 
-  auto buffer = serialization::BufferBuilder<Event>{}.set_data_size(data.size()).build();
+  auto buffer = BasePrivate::build_message(
+      MessageType::Event,
+      serialization::BufferBuilder<Event>{}.set_data_size(data.size()).buffer_size());
 
-  Event event(buffer);
+  Event event(Message(buffer).data());
 
   utils::span::copy<uint8_t>(event.data(), data);
 
-  impl_->send_message(stream_identifier, MessageType::Event, std::move(buffer));
+  impl_->send_message(stream_identifier, std::move(buffer));
 }
 
-void Server::send_exception(size_t request_identifier, size_t code) {
+void Server::send_event(size_t stream_identifier, SharedEvent event) {
   std::unique_lock lock(impl_->mutex);
 
   if (!is_open()) {
     throw std::runtime_error("is not open");
   }
 
+  impl_->send_message(stream_identifier, std::move(event));
+}
+
+void Server::send_exception(size_t request_identifier, size_t code) {
+  if (!try_send_exception(request_identifier, code)) {
+    throw std::runtime_error("is not open");
+  }
+}
+
+void Server::send_response(size_t request_identifier, std::span<const uint8_t> data) {
+  auto response = build_response(data.size());
+
+  utils::span::copy<uint8_t>(response.data(), data);
+
+  send_response(request_identifier, std::move(response));
+}
+
+void Server::send_response(size_t request_identifier, ResponseBuffer&& response) {
+  if (!try_send_response(request_identifier, std::move(response))) {
+    throw std::runtime_error("is not open");
+  }
+}
+
+bool Server::try_send_exception(size_t request_identifier, size_t code) {
+  std::unique_lock lock(impl_->mutex);
+
+  if (!is_open()) {
+    return false;
+  }
+
   if (code > max_exception_code()) {
     throw std::runtime_error("code exceeds maximum value");
   }
@@ -79,24 +159,26 @@ void Server::send_exception(size_t request_identifier, size_t code) {
     throw std::runtime_error("request not found");
   }
 
-  auto buffer = serialization::BufferBuilder<Exception>{}.build();
+  auto buffer = BasePrivate::build_message(MessageType::Exception,
+                                           serialization::BufferBuilder<Exception>{}.buffer_size());
 
-  Exception exception(buffer);
+  Exception exception(Message(buffer).data());
 
   exception.id() = request_identifier;
   exception.code() = code;
 
-  impl_->send_message(unresponded_requests_iterator->second, MessageType::Exception,
-                      std::move(buffer));
+  impl_->send_message(unresponded_requests_iterator->second, std::move(buffer));
 
   impl_->unresponded_requests.erase(unresponded_requests_iterator);
+
+  return true;
 }
 
-void Server::send_response(size_t request_identifier, std::span<const uint8_t> data) {
+bool Server::try_send_response(size_t request_identifier, ResponseBuffer&& response) {
   std::unique_lock lock(impl_->mutex);
 
   if (!is_open()) {
-    throw std::runtime_error("is not open");
+    return false;
   }
 
   auto unresponded_requests_iterator = impl_->unresponded_requests.find(request_identifier);
@@ -105,18 +187,19 @@ void Server::send_response(size_t request_identifier, std::span<const uint8_t> d
     throw std::runtime_error("request not found");
   }
 
-  auto buffer = serialization::BufferBuilder<Response>{}.set_data_size(data.size()).build();
-
-  Response response(buffer);
+  auto buffer = std::move(response.buffer_);
 
-  response.id() = request_identifier;
+  if (buffer.empty()) {
+    buffer = std::move(build_response(0).buffer_);
+  }
 
-  utils::span::copy<uint8_t>(response.data(), data);
+  Response(Message(buffer).data()).id() = request_identifier;
 
-  impl_->send_message(unresponded_requests_iterator->second, MessageType::Response,
-                      std::move(buffer));
+  impl_->send_message(unresponded_requests_iterator->second, std::move(buffer));
 
   impl_->unresponded_requests.erase(unresponded_requests_iterator);
+
+  return true;
 }
 
 std::shared_ptr<Server::NewRequestEvent> Server::new_request() const {
@@ -127,7 +210,8 @@ ServerPrivate::ServerPrivate() : new_request_event(Server::NewRequestEvent::crea
 
 ServerPrivate::~ServerPrivate() = default;
 
-void ServerPrivate::handle(size_t stream_identifier, Request request) {
+void ServerPrivate::handle(size_t stream_identifier, Request request,
+                           std::vector<uint8_t>&& buffer) {
   if (!request.validate()) {
     return;
   }
@@ -140,18 +224,19 @@ void ServerPrivate::handle(size_t stream_identifier, Request request) {
     return;
   }
 
-  std::vector<uint8_t> data(request.data().size());
-  std::memcpy(data.data(), request.data().data(), data.size());
+  const size_t request_identifier = request.id();
 
-  pending_requests.emplace_back(request.id(), stream_identifier, std::move(data));
+  pending_requests.emplace_back(request_identifier, stream_identifier,
+                                Payload(std::move(buffer), request.data()));
 
   new_request_event->emit();
 }
 
-void ServerPrivate::message_handler(size_t stream_identifier, Message message) {
+void ServerPrivate::message_handler(size_t stream_identifier, Message message,
+                                    std::vector<uint8_t>&& buffer) {
   switch (message.type()) {
     case MessageType::Request:
-      handle(stream_identifier, Request(message.data()));
+      handle(stream_identifier, Request(message.data()), std::move(buffer));
       break;
     default:
       return;
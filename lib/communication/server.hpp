@@ -1,6 +1,8 @@
 #pragma once
 
+#include <memory>
 #include <optional>
+#include <vector>
 
 #include "detail/base.hpp"
 
@@ -16,18 +18,78 @@ class Server : public detail::Base {
  public:
   using NewRequestEvent = utils::Event<>;
 
+  using SharedEvent = std::shared_ptr<const std::vector<uint8_t>>;
+
+  // Event message whose data is written in place like a ResponseBuffer's, then shared.
+  class EventBuffer {
+   public:
+    EventBuffer(const EventBuffer&) = delete;
+    EventBuffer(EventBuffer&&) noexcept = default;
+    ~EventBuffer();
+
+    EventBuffer& operator=(const EventBuffer&) = delete;
+    EventBuffer& operator=(EventBuffer&&) noexcept = default;
+
+    [[nodiscard]] std::span<uint8_t> data();
+
+    [[nodiscard]] SharedEvent share() &&;
+
+   private:
+    explicit EventBuffer(std::vector<uint8_t>&& buffer);
+
+   private:
+    std::vector<uint8_t> buffer_;
+
+   private:
+    friend Server;
+  };
+
+  // Response message whose data is written in place, e.g. by serializing straight into data(),
+  // so it is not copied on its way out. A default constructed one holds an empty response.
+  class ResponseBuffer {
+   public:
+    ResponseBuffer() = default;
+    ResponseBuffer(const ResponseBuffer&) = delete;
+    ResponseBuffer(ResponseBuffer&&) noexcept = default;
+    ~ResponseBuffer();
+
+    ResponseBuffer& operator=(const ResponseBuffer&) = delete;
+    ResponseBuffer& operator=(ResponseBuffer&&) noexcept = default;
+
+    [[nodiscard]] std::span<uint8_t> data();
+
+   private:
+    explicit ResponseBuffer(std::vector<uint8_t>&& buffer);
+
+   private:
+    std::vector<uint8_t> buffer_;
+
+   private:
+    friend Server;
+  };
+
  public:
   explicit Server();
   ~Server() override;
 
+  // Frames data as an event once, so it can be sent on any number of servers without being
+  // copied per connection.
+  static SharedEvent build_event(std::span<const uint8_t> data);
+
+  static EventBuffer build_event(size_t data_size);
+
+  static ResponseBuffer build_response(size_t data_size);
+
   [[nodiscard]] bool has_pending_requests() const;
 
   [[nodiscard]] size_t max_exception_code() const;
 
-  std::optional<std::pair<size_t, std::vector<uint8_t>>> next_pending_request();
+  std::optional<std::pair<size_t, Payload>> next_pending_request();
 
   void send_event(size_t stream_identifier, std::span<const uint8_t> data);
 
+  void send_event(size_t stream_identifier, SharedEvent event);
+
   template <typename T>
   auto send_exception(size_t request_identifier, T code) requires(std::is_enum_v<T>) {
     return send_exception(request_identifier, static_cast<size_t>(code));
@@ -37,6 +99,19 @@ class Server : public detail::Base {
 
   void send_response(size_t request_identifier, std::span<const uint8_t> data);
 
+  void send_response(size_t request_identifier, ResponseBuffer&& response);
+
+  // Like send_exception and send_response, but return false instead of throwing when the
+  // connection is closed, which it may be at any time for whoever answers off its thread.
+  template <typename T>
+  bool try_send_exception(size_t request_identifier, T code) requires(std::is_enum_v<T>) {
+    return try_send_exception(request_identifier, static_cast<size_t>(code));
+  }
+
+  bool try_send_exception(size_t request_identifier, size_t code);
+
+  bool try_send_response(size_t request_identifier, ResponseBuffer&& response);
+
  public:
   [[nodiscard]] std::shared_ptr<NewRequestEvent> new_request() const;
 
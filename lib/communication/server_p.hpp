@@ -15,16 +15,16 @@ class ServerPrivate : public detail::BasePrivate {
   explicit ServerPrivate();
   ~ServerPrivate() override;
 
-  void handle(size_t stream_identifier, Request request);
+  void handle(size_t stream_identifier, Request request, std::vector<uint8_t>&& buffer);
 
  public:
-  void message_handler(size_t stream_identifier, Message message) override;
+  void message_handler(size_t stream_identifier, Message message,
+                       std::vector<uint8_t>&& buffer) override;
 
  public:
   std::shared_ptr<Server::NewRequestEvent> new_request_event;
 
-  std::deque<std::tuple<size_t /* request_identifier */, size_t /* stream_identifier */,
-                        std::vector<uint8_t>>>
+  std::deque<std::tuple<size_t /* request_identifier */, size_t /* stream_identifier */, Payload>>
       pending_requests;
   std::unordered_map<size_t /* request_identifier */, size_t /* stream_identifier */>
       unresponded_requests;
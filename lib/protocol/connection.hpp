@@ -1,6 +1,8 @@
 #pragma once
 
 #include <asio/generic/datagram_protocol.hpp>
+#include <chrono>
+#include <functional>
 #include <optional>
 
 #include "detail/connection/api/types/connection_id.hpp"
@@ -11,6 +13,7 @@ namespace protocol {
 namespace detail {
 
 class ConnectionPrivate;
+class ServerPrivate;
 
 }
 
@@ -36,11 +39,65 @@ class Connection {
   using ReadyReadEvent = utils::Event<size_t /* stream_identifier */>;
   using StateChangedEvent = utils::Event<State /* new_state */>;
 
+ public:
+  // Deterministic impairment of outbound datagrams, for reproducing lossy or slow links on
+  // loopback. Every random decision is drawn from a generator seeded with seed.
+  struct NetworkImpairment {
+    // Two state loss model for bursty losses, replaces loss when set. By default the link never
+    // turns bad, so nothing is lost until good_to_bad is set.
+    struct GilbertElliott {
+      double bad_loss = 1.0;
+      double bad_to_good = 1.0;  // per datagram transition probability
+      double good_loss = 0.0;
+      double good_to_bad = 0.0;  // per datagram transition probability
+    };
+
+    std::optional<size_t> bandwidth;  // bytes per second
+    std::chrono::microseconds delay{0};
+    double duplication = 0.0;
+    std::optional<GilbertElliott> gilbert_elliott;
+    std::chrono::microseconds jitter{0};  // uniformly distributed extra delay
+    double loss = 0.0;
+    std::optional<size_t> queue_limit;  // bytes held back, datagrams beyond are dropped
+    double reordering = 0.0;  // datagrams skipping the delay, overtaking those in flight
+    uint64_t seed = 0;
+  };
+
+  // Snapshot of the transport state, counters accumulate since associate().
+  struct Statistics {
+    size_t abandoned_chunks;  // partially reliable chunks given up on
+    size_t bytes_in_flight;
+    size_t bytes_received;
+    size_t bytes_sent;
+    size_t cwnd;
+    size_t decrypt_failures;
+    size_t fast_recovery_entries;
+    size_t fast_retransmissions;  // chunks
+    size_t gap_ack_blocks;        // reported to the peer
+    float handshake_time;         // milliseconds, from associate() to Established
+    size_t in_flight_chunks;
+    size_t out_of_order_chunks;  // received, held for reordering or reassembly
+    size_t packets_received;
+    size_t packets_sent;
+    size_t pending_chunks;  // queued, not transmitted yet
+    size_t replay_rejections;
+    size_t retransmissions;  // chunks, after a retransmission timeout
+    uint32_t rto;            // milliseconds
+    float rttvar;            // milliseconds
+    float srtt;              // milliseconds
+    size_t ssthresh;
+    size_t timeouts;  // retransmission timer expiries
+  };
+
  private:
   struct BaseConfiguration {
     std::shared_ptr<asio::generic::datagram_protocol::socket> rx_socket;
     std::shared_ptr<asio::generic::datagram_protocol::socket> tx_socket;
     std::optional<asio::generic::datagram_protocol::endpoint> peer_endpoint;
+    // Idle period after which an established connection releases its timers and transient
+    // buffers until the next inbound packet or Stream::write. Disabled when empty.
+    std::optional<std::chrono::milliseconds> hibernation_interval;
+    std::optional<NetworkImpairment> network_impairment;
   };
 
  public:
@@ -58,20 +115,33 @@ class Connection {
 
   void abort();
 
+  // Throws unless the connection is closed, so that only one of concurrent calls succeeds. The
+  // association itself completes on the strand and is reported by state_changed. Streams keep
+  // their identity and reliability params across associations.
   void associate(ClientConfiguration&& config);
 
   void associate(ServerConfiguration&& config);
 
+  // Runs handler on the connection strand, inline when already there.
+  void dispatch(std::function<void()> handler) const;
+
+  // The io_context the connection was placed on, its strand runs there.
+  [[nodiscard]] asio::io_context& io_context() const;
+
   [[nodiscard]] size_t max_num_streams() const;
 
   // option
 
+  // Must be called on the connection strand, e.g. from a ready_read handler.
   [[nodiscard]] std::optional<size_t> readable_stream() const;
 
   void shutdown();
 
   [[nodiscard]] State state() const;
 
+  // Can be called from any thread.
+  [[nodiscard]] Statistics statistics() const;
+
   [[nodiscard]] Type type() const;
 
   const Stream& operator[](size_t stream_identifier) const;
@@ -85,6 +155,9 @@ class Connection {
 
  private:
   const std::shared_ptr<detail::ConnectionPrivate> impl_;
+
+ private:
+  friend detail::ServerPrivate;
 };
 
 }  // namespace protocol
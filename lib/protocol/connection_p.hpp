@@ -1,12 +1,14 @@
 #pragma once
 
 #include <asio/io_context_strand.hpp>
-#include <shared_mutex>
 
 #include "connection.hpp"
 #include "detail/connection/ack_manager.hpp"
+#include "detail/connection/command_queue.hpp"
 #include "detail/connection/congestion_manager.hpp"
+#include "detail/connection/connection_statistics.hpp"
 #include "detail/connection/crypto_manager.hpp"
+#include "detail/connection/hibernation_manager.hpp"
 #include "detail/connection/in_data_queue.hpp"
 #include "detail/connection/internal_data.hpp"
 #include "detail/connection/network_manager.hpp"
@@ -31,15 +33,20 @@ class ConnectionPrivate : public std::enable_shared_from_this<ConnectionPrivate>
   virtual ~ConnectionPrivate();
 
  public:
+  void associate(Connection::ClientConfiguration&& config);
+
+  void associate(Connection::ServerConfiguration&& config);
+
   void reset() override;
 
  public:
   asio::io_context& io_context;
   asio::io_context::strand strand;
-  std::recursive_mutex mutex;
 
   InternalData internal_data;
+  ConnectionStatistics statistics;
 
+  CommandQueue command_queue;
   InDataQueue in_data_queue;
   OutControlQueue out_control_queue;
   OutDataQueue out_data_queue;
@@ -47,6 +54,7 @@ class ConnectionPrivate : public std::enable_shared_from_this<ConnectionPrivate>
   AckManager ack_manager;
   CongestionManager congestion_manager;
   CryptoManager crypto_manager;
+  HibernationManager hibernation_manager;
   NetworkManager network_manager;
   PacketBuilder packet_builder;
   PacketHandler packet_handler;
@@ -1,57 +1,96 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <asio/generic/datagram_protocol.hpp>
 #include <optional>
 
+#include "datagram_pool.hpp"
 #include "utils/debug/assert.hpp"
 
 namespace protocol {
 
 namespace detail {
 
+// Waits for readability instead of keeping a receive operation armed, so an idle socket does not
+// pin a datagram-sized buffer. Ready datagrams are drained with non-blocking receives straight
+// into pooled blocks, which are then handed on without copying.
 template <typename Executor, typename DatagramProtocol>
 void async_recursive_read_datagram(
     Executor& executor,
     const std::shared_ptr<asio::basic_datagram_socket<DatagramProtocol>>& socket,
-    const std::function<void(std::vector<uint8_t>, typename DatagramProtocol::endpoint)>&
+    const std::function<void(DatagramSlice, typename DatagramProtocol::endpoint)>&
         handler_ex) {
   ASSERT(socket != nullptr);
   ASSERT(handler_ex != nullptr);
 
-  auto buffer = std::make_shared<std::vector<uint8_t>>(std::numeric_limits<uint16_t>::max());
-  auto endpoint = std::make_shared<typename DatagramProtocol::endpoint>();
+  static constexpr size_t MAX_DATAGRAMS_PER_WAIT = 64;
 
-  asio::mutable_buffer buffer_view(buffer->data(), buffer->size());
+  asio::error_code ignored_error;
 
-  auto handler = [&executor, weak_socket = std::weak_ptr(socket), buffer, buffer_view, endpoint,
-                  handler_ex](auto&& self, const asio::error_code& error,
-                              size_t bytes_transferred) {
+  socket->non_blocking(true, ignored_error);
+
+  auto handler = [&executor, weak_socket = std::weak_ptr(socket), handler_ex](
+                     auto&& self, const asio::error_code& error) {
     if (error) [[unlikely]] {
       if (error == asio::error::operation_aborted) {
         return;
       }
-    } else {
-      std::vector<uint8_t> data(bytes_transferred);
-      std::memcpy(data.data(), buffer->data(), data.size());
-
-      asio::post(executor,
-                 [handler_ex, data = std::move(data), endpoint = std::move(*endpoint)]() mutable {
-                   return handler_ex(std::move(data), std::move(endpoint));
-                 });
+    } else if (auto socket = weak_socket.lock()) [[likely]] {
+      for (size_t i = 0; i < MAX_DATAGRAMS_PER_WAIT; ++i) {
+        typename DatagramProtocol::endpoint endpoint;
+        asio::error_code receive_error;
+
+        // Size of the next datagram, so that oversized ones are not truncated.
+        const size_t available = socket->available(receive_error);
+
+        if (receive_error) {
+          break;
+        }
+
+        if (available == 0) {
+          // Nothing is queued or the next datagram is empty, in which case it is dropped.
+          std::array<uint8_t, 1> sink;
+
+          socket->receive(asio::buffer(sink), 0, receive_error);
+
+          if (receive_error) {
+            break;
+          }
+
+          continue;
+        }
+
+        auto data = DatagramSlice::allocate(std::max(available, DatagramPool::BLOCK_SIZE));
+
+        auto bytes_transferred = socket->receive_from(asio::buffer(data.data(), data.size()),
+                                                      endpoint, 0, receive_error);
+
+        if (receive_error) {
+          break;
+        }
+
+        data.shrink(bytes_transferred);
+
+        asio::post(executor,
+                   [handler_ex, data = std::move(data), endpoint = std::move(endpoint)]() mutable {
+                     return handler_ex(std::move(data), std::move(endpoint));
+                   });
+      }
     }
 
     if (auto socket = weak_socket.lock()) [[likely]] {
-      socket->async_receive_from(
-          buffer_view, *endpoint, [self = std::move(self)](auto&& PH1, auto&& PH2) {
-            return self(self, std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2));
-          });
+      socket->async_wait(asio::socket_base::wait_read,
+                         [self = std::move(self)](const asio::error_code& error) {
+                           return self(self, error);
+                         });
     }
   };
 
-  socket->async_receive_from(
-      buffer_view, *endpoint, [handler = std::move(handler)](auto&& PH1, auto&& PH2) {
-        return handler(handler, std::forward<decltype(PH1)>(PH1), std::forward<decltype(PH2)>(PH2));
-      });
+  socket->async_wait(asio::socket_base::wait_read,
+                     [handler = std::move(handler)](const asio::error_code& error) {
+                       return handler(handler, error);
+                     });
 }
 
 }  // namespace detail
@@ -2,17 +2,23 @@
 
 #include <asio/generic/datagram_protocol.hpp>
 #include <optional>
+#include <type_traits>
+#include <vector>
 
+#include "datagram_pool.hpp"
+#include "serialization/buffer_pool.hpp"
 #include "utils/debug/assert.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-template <typename DatagramProtocol>
+// Buffer is either a std::vector<uint8_t>, returned to the buffer pool once sent, or a
+// DatagramSlice, forwarded as received.
+template <typename DatagramProtocol, typename Buffer>
 void async_send_datagram(asio::basic_datagram_socket<DatagramProtocol>& socket,
                          const std::optional<typename DatagramProtocol::endpoint>& endpoint,
-                         std::vector<uint8_t> data) {
+                         Buffer data) {
   auto buffer = std::make_shared<decltype(data)>(std::move(data));
 
   asio::const_buffer buffer_view(buffer->data(), buffer->size());
@@ -22,6 +28,10 @@ void async_send_datagram(asio::basic_datagram_socket<DatagramProtocol>& socket,
     if (!error) [[likely]] {
       ASSERT(bytes_transferred == buffer->size());
     }
+
+    if constexpr (std::is_same_v<Buffer, std::vector<uint8_t>>) {
+      serialization::BufferPool::release(std::move(*buffer));
+    }
   };
 
   if (endpoint.has_value()) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <iterator>
 #include <limits>
 #include <vector>
 
@@ -13,41 +14,103 @@ namespace protocol {
 
 namespace detail {
 
-class ChunkList : public serialization::PackedStruct {
+class ChunkList final : public serialization::PackedStruct {
+ public:
+  using size_type = serialization::pu8;
+  using chunk_data_type = serialization::PackedDynamicArray<uint8_t, serialization::pu16>;
+
+ public:
+  // Walks chunks front to back, each step is O(1). Only valid on a validated chunk list. Like
+  // std::span, a const chunk list is a view of chunks that are not const.
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = chunk_data_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = chunk_data_type *;
+    using reference = chunk_data_type &;
+
+   public:
+    Iterator() = default;
+
+    reference operator*() const { return chunk_list_->jmp_ref<chunk_data_type>(offset_); }
+    pointer operator->() const { return &**this; }
+
+    Iterator &operator++() {
+      offset_ += sizeof(chunk_data_type::size_type) + (**this).size();
+      ++index_;
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const Iterator &other) const { return index_ == other.index_; }
+
+   private:
+    Iterator(ChunkList *chunk_list, size_t index, size_t offset)
+        : chunk_list_(chunk_list), index_(index), offset_(offset) {}
+
+   private:
+    ChunkList *chunk_list_ = nullptr;
+    size_t index_ = 0;
+    size_t offset_ = 0;
+
+   private:
+    friend class ChunkList;
+  };
+
  public:
   using PackedStruct::PackedStruct;
 
   auto &size() { return jmp_ref<size_type>(size_offset()); }
   auto &chunk_data(size_t n) { return jmp_ref<chunk_data_type>(chunk_data_offset(n)); }
 
-  bool validate() override {
+  Iterator begin() const { return Iterator(view(), 0, first_chunk_data_offset()); }
+  Iterator end() const { return Iterator(view(), view()->size(), 0); }
+
+  // Single pass over the chunks, checking that each of them lies within the list.
+  bool validate() const {
     if (!range_check(size_offset(), sizeof(size_type))) {
       return false;
     }
-    for (size_t i = 0; i < size(); ++i) {
-      if (!range_check(chunk_data_offset(i) + chunk_data(i).size_offset(),
-                       sizeof(chunk_data_type::size_type))) {
+
+    size_t offset = first_chunk_data_offset();
+
+    for (size_t i = 0; i < view()->size(); ++i) {
+      if (!range_check(offset, sizeof(chunk_data_type::size_type))) {
         return false;
       }
-      if (!range_check(chunk_data_offset(i) + chunk_data(i).data_offset(), chunk_data(i).size())) {
+
+      const size_t chunk_data_size = view()->jmp_ref<chunk_data_type>(offset).size();
+
+      if (!range_check(offset + sizeof(chunk_data_type::size_type), chunk_data_size)) {
         return false;
       }
+
+      offset += sizeof(chunk_data_type::size_type) + chunk_data_size;
     }
 
     return true;
   }
 
- public:
-  using size_type = serialization::pu8;
-  using chunk_data_type = serialization::PackedDynamicArray<uint8_t, serialization::pu16>;
-
  private:
-  size_t size_offset() { return 0; }
+  ChunkList *view() const { return const_cast<ChunkList *>(this); }
+
+  size_t size_offset() const { return 0; }
+  size_t first_chunk_data_offset() const { return size_offset() + sizeof(size_type); }
+  // Walks from the front, only used while the chunk list is being built.
   size_t chunk_data_offset(size_t n) {
-    if (n == 0) {
-      return size_offset() + sizeof(size_type);
+    size_t offset = first_chunk_data_offset();
+
+    for (size_t i = 0; i < n; ++i) {
+      offset += sizeof(chunk_data_type::size_type) + jmp_ref<chunk_data_type>(offset).size();
     }
-    return chunk_data_offset(n - 1) + sizeof(chunk_data_type::size_type) + chunk_data(n - 1).size();
+
+    return offset;
   }
 };
 
@@ -67,7 +130,7 @@ class BufferBuilder<ChunkList, Tags...> {
  public:
   BufferBuilder() : dynamic_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + dynamic_size(); }
 
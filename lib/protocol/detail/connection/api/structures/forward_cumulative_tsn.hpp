@@ -5,36 +5,27 @@
 #include "../types/forward_tsn_stream.hpp"
 #include "../types/transmission_sequence_number.hpp"
 #include "serialization/buffer_builder.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class ForwardCumulativeTSN : public serialization::PackedStruct {
- public:
-  using PackedStruct::PackedStruct;
-
-  auto &new_cumulative_tsn() {
-    return jmp_ref<new_cumulative_tsn_type>(new_cumulative_tsn_offset());
-  }
-  auto streams() {
-    return streams_type(jmp_ptr<streams_type::value_type>(streams_offset()), num_streams());
-  }
-
-  bool validate() override { return true; }
-
+class ForwardCumulativeTSN final : public serialization::PackedLayoutStruct<ForwardCumulativeTSN> {
  public:
   using new_cumulative_tsn_type =
       serialization::PackedInteger<TransmissionSequenceNumber::value_type>;
   using streams_type = std::span<ForwardTsnStream>;
 
- private:
-  size_t new_cumulative_tsn_offset() { return 0; }
-  size_t streams_offset() { return new_cumulative_tsn_offset() + sizeof(new_cumulative_tsn_type); }
-  size_t num_streams() {
-    return (raw_size() - streams_offset()) / sizeof(streams_type::value_type);
-  }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Fixed<new_cumulative_tsn_type>,
+                                  serialization::field::Tail<streams_type::value_type>>;
+
+ public:
+  using PackedLayoutStruct::PackedLayoutStruct;
+
+  auto &new_cumulative_tsn() { return get<0>(); }
+  auto streams() { return get<1>(); }
 };
 
 }  // namespace detail
@@ -48,12 +39,12 @@ using namespace protocol::detail;
 template <typename... Tags>
 class BufferBuilder<ForwardCumulativeTSN, Tags...> {
  public:
-  static constexpr size_t static_size = sizeof(ForwardCumulativeTSN::new_cumulative_tsn_type);
+  static constexpr size_t static_size = ForwardCumulativeTSN::layout_type::static_size;
 
  public:
   BufferBuilder() : dynamic_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + dynamic_size(); }
 
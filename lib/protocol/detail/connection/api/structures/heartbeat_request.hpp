@@ -4,31 +4,22 @@
 
 #include "../types/heartbeat_info.hpp"
 #include "serialization/buffer_builder.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class HeartbeatRequest : public serialization::PackedStruct {
+class HeartbeatRequest final : public serialization::PackedLayoutStruct<HeartbeatRequest> {
  public:
-  using PackedStruct::PackedStruct;
-
-  auto &hb_info() { return jmp_ref<hb_info_type>(hb_info_offset()); }
-
-  bool validate() override {
-    if (!range_check(hb_info_offset(), sizeof(hb_info_type))) {
-      return false;
-    }
+  using hb_info_type = HeartbeatInfo;
 
-    return true;
-  }
+  using layout_type = serialization::PackedLayout<serialization::field::Fixed<hb_info_type>>;
 
  public:
-  using hb_info_type = HeartbeatInfo;
+  using PackedLayoutStruct::PackedLayoutStruct;
 
- private:
-  size_t hb_info_offset() { return 0; }
+  auto &hb_info() { return get<0>(); }
 };
 
 }  // namespace detail
@@ -44,9 +35,9 @@ class BufferBuilder<HeartbeatRequest, Tags...> {
  public:
   BufferBuilder() = default;
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
-  size_t buffer_size() { return sizeof(HeartbeatRequest::hb_info_type); }
+  size_t buffer_size() { return HeartbeatRequest::layout_type::static_size; }
 };
 
 }  // namespace serialization
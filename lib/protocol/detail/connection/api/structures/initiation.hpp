@@ -6,70 +6,30 @@
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_dynamic_array.hpp"
 #include "serialization/packed_integer.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 #include "utils/debug/assert.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class Initiation : public serialization::PackedStruct {
- public:
-  using PackedStruct::PackedStruct;
-
- public:
-  auto &public_key_a() { return jmp_ref<public_key_a_type>(public_key_a_offset()); }
-  auto &public_key_b() { return jmp_ref<public_key_b_type>(public_key_b_offset()); }
-  auto &public_key_b_mac() { return jmp_ref<public_key_b_mac_type>(public_key_b_mac_offset()); }
-
-  bool validate() override {
-    if (!range_check(public_key_a_offset() + public_key_a().size_offset(),
-                     sizeof(public_key_a_type::size_type))) {
-      return false;
-    }
-    if (public_key_a().size() != 0) {
-      if (!range_check(public_key_a_offset() + public_key_a().data_offset(),
-                       public_key_a().size())) {
-        return false;
-      }
-    }
-    if (!range_check(public_key_b_offset() + public_key_b().size_offset(),
-                     sizeof(public_key_b_type::size_type))) {
-      return false;
-    }
-    if (public_key_b().size() != 0) {
-      if (!range_check(public_key_b_offset() + public_key_b().data_offset(),
-                       public_key_b().size())) {
-        return false;
-      }
-    }
-    if (!range_check(public_key_b_mac_offset() + public_key_b_mac().size_offset(),
-                     sizeof(public_key_b_mac_type::size_type))) {
-      return false;
-    }
-    if (public_key_b_mac().size() != 0) {
-      if (!range_check(public_key_b_mac_offset() + public_key_b_mac().data_offset(),
-                       public_key_b_mac().size())) {
-        return false;
-      }
-    }
-
-    return true;
-  }
-
+class Initiation final : public serialization::PackedLayoutStruct<Initiation> {
  public:
   using public_key_a_type = serialization::PackedDynamicArray<uint8_t, serialization::pu16>;
   using public_key_b_type = serialization::PackedDynamicArray<uint8_t, serialization::pu16>;
   using public_key_b_mac_type = serialization::PackedDynamicArray<uint8_t, serialization::pu8>;
 
- private:
-  size_t public_key_a_offset() { return 0; }
-  size_t public_key_b_offset() {
-    return public_key_a_offset() + sizeof(public_key_a_type::size_type) + public_key_a().size();
-  }
-  size_t public_key_b_mac_offset() {
-    return public_key_b_offset() + sizeof(public_key_b_type::size_type) + public_key_b().size();
-  }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Dynamic<public_key_a_type>,
+                                  serialization::field::Dynamic<public_key_b_type>,
+                                  serialization::field::Dynamic<public_key_b_mac_type>>;
+
+ public:
+  using PackedLayoutStruct::PackedLayoutStruct;
+
+  auto &public_key_a() { return get<0>(); }
+  auto &public_key_b() { return get<1>(); }
+  auto &public_key_b_mac() { return get<2>(); }
 };
 
 }  // namespace detail
@@ -83,14 +43,12 @@ using namespace protocol::detail;
 template <typename... Tags>
 class BufferBuilder<Initiation, Tags...> {
  public:
-  static constexpr size_t static_size = sizeof(Initiation::public_key_a_type::size_type) +
-                                        sizeof(Initiation::public_key_b_type::size_type) +
-                                        sizeof(Initiation::public_key_b_mac_type::size_type);
+  static constexpr size_t static_size = Initiation::layout_type::static_size;
 
  public:
   BufferBuilder() : dynamic_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); };
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + dynamic_size(); }
 
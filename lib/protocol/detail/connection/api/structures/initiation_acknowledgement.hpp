@@ -7,60 +7,31 @@
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_dynamic_array.hpp"
 #include "serialization/packed_integer.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 #include "utils/debug/assert.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class InitiationAcknowledgement : public serialization::PackedStruct {
- public:
-  using PackedStruct::PackedStruct;
-
- public:
-  auto &connection_id() { return jmp_ref<connection_id_type>(connection_id_offset()); }
-  auto &public_key_a() { return jmp_ref<public_key_a_type>(public_key_a_offset()); }
-  auto &public_key_a_mac() { return jmp_ref<public_key_a_mac_type>(public_key_a_mac_offset()); }
-
-  bool validate() override {
-    if (!range_check(connection_id_offset(), sizeof(connection_id_type))) {
-      return false;
-    }
-    if (!range_check(public_key_a_offset() + public_key_a().size_offset(),
-                     sizeof(public_key_a_type::size_type))) {
-      return false;
-    }
-    if (public_key_a().size() != 0) {
-      if (!range_check(public_key_a_offset() + public_key_a().data_offset(),
-                       public_key_a().size())) {
-        return false;
-      }
-    }
-    if (!range_check(public_key_a_mac_offset() + public_key_a_mac().size_offset(),
-                     sizeof(public_key_a_mac_type::size_type))) {
-      return false;
-    }
-    if (public_key_a_mac().size() != 0) {
-      if (!range_check(public_key_a_mac_offset() + public_key_a_mac().data_offset(),
-                       public_key_a_mac().size())) {
-        return false;
-      }
-    }
-    return true;
-  }
-
+class InitiationAcknowledgement final
+    : public serialization::PackedLayoutStruct<InitiationAcknowledgement> {
  public:
   using connection_id_type = serialization::PackedInteger<ConnectionID>;
   using public_key_a_type = serialization::PackedDynamicArray<uint8_t, serialization::pu16>;
   using public_key_a_mac_type = serialization::PackedDynamicArray<uint8_t, serialization::pu8>;
 
- private:
-  size_t connection_id_offset() { return 0; }
-  size_t public_key_a_offset() { return connection_id_offset() + sizeof(connection_id_type); }
-  size_t public_key_a_mac_offset() {
-    return public_key_a_offset() + sizeof(public_key_a_type::size_type) + public_key_a().size();
-  }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Fixed<connection_id_type>,
+                                  serialization::field::Dynamic<public_key_a_type>,
+                                  serialization::field::Dynamic<public_key_a_mac_type>>;
+
+ public:
+  using PackedLayoutStruct::PackedLayoutStruct;
+
+  auto &connection_id() { return get<0>(); }
+  auto &public_key_a() { return get<1>(); }
+  auto &public_key_a_mac() { return get<2>(); }
 };
 
 }  // namespace detail
@@ -74,15 +45,12 @@ using namespace protocol::detail;
 template <typename... Tags>
 class BufferBuilder<InitiationAcknowledgement, Tags...> {
  public:
-  static constexpr size_t static_size =
-      sizeof(InitiationAcknowledgement::connection_id_type) +
-      sizeof(InitiationAcknowledgement::public_key_a_type::size_type) +
-      sizeof(InitiationAcknowledgement::public_key_a_mac_type::size_type);
+  static constexpr size_t static_size = InitiationAcknowledgement::layout_type::static_size;
 
  public:
   BufferBuilder() : dynamic_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); };
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + dynamic_size(); }
 
@@ -3,51 +3,34 @@
 #include "../types/connection_id.hpp"
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_integer.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class Packet : public serialization::PackedStruct {
+class Packet final : public serialization::PackedLayoutStruct<Packet> {
  public:
   struct Bits {
     bool e : 1;
   };
 
- public:
-  using PackedStruct::PackedStruct;
-
-  auto &bits() { return jmp_ref<bits_type>(bits_offset()); }
-  auto &connection_id() { return jmp_ref<connection_id_type>(connection_id_offset()); }
-  auto data() { return data_type(jmp_ptr<data_type::value_type>(data_offset()), data_size()); }
-
-  bool validate() override {
-    if (!range_check(bits_offset(), sizeof(bits_type))) {
-      return false;
-    }
-    if (!range_check(connection_id_offset(), sizeof(connection_id_type))) {
-      return false;
-    }
-    if (data_size() != 0) {
-      if (!range_check(data_offset(), data_size())) {
-        return false;
-      }
-    }
-
-    return true;
-  }
-
  public:
   using bits_type = Bits;
   using connection_id_type = serialization::PackedInteger<ConnectionID>;
   using data_type = std::span<uint8_t>;
 
- private:
-  size_t bits_offset() { return 0; }
-  size_t connection_id_offset() { return bits_offset() + sizeof(bits_type); }
-  size_t data_offset() { return connection_id_offset() + sizeof(connection_id_type); }
-  size_t data_size() { return raw_size() - data_offset(); }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Fixed<bits_type>,
+                                  serialization::field::Fixed<connection_id_type>,
+                                  serialization::field::Tail<data_type::value_type>>;
+
+ public:
+  using PackedLayoutStruct::PackedLayoutStruct;
+
+  auto &bits() { return get<0>(); }
+  auto &connection_id() { return get<1>(); }
+  auto data() { return get<2>(); }
 };
 
 }  // namespace detail
@@ -61,13 +44,12 @@ using namespace protocol::detail;
 template <typename... Tags>
 class BufferBuilder<Packet, Tags...> {
  public:
-  static constexpr size_t static_size =
-      sizeof(Packet::bits_type) + sizeof(Packet::connection_id_type);
+  static constexpr size_t static_size = Packet::layout_type::static_size;
 
  public:
   BufferBuilder() : dynamic_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); };
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + dynamic_size(); }
 
@@ -7,13 +7,13 @@
 #include "../types/transmission_sequence_number.hpp"
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_integer.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class PayloadData : public serialization::PackedStruct {
+class PayloadData final : public serialization::PackedLayoutStruct<PayloadData> {
  public:
   struct Bits {
     bool b : 1;
@@ -21,35 +21,6 @@ class PayloadData : public serialization::PackedStruct {
     bool u : 1;
   };
 
- public:
-  using PackedStruct::PackedStruct;
-
-  auto &bits() { return jmp_ref<bits_type>(bits_offset()); }
-  auto &tsn() { return jmp_ref<tsn_type>(tsn_offset()); }
-  auto &sid() { return jmp_ref<sid_type>(sid_offset()); }
-  auto &ssn() { return jmp_ref<ssn_type>(ssn_offset()); }
-  auto data() { return data_type(jmp_ptr<data_type::value_type>(data_offset()), data_size()); }
-
-  bool validate() override {
-    if (!range_check(bits_offset(), sizeof(bits_type))) {
-      return false;
-    }
-    if (!range_check(tsn_offset(), sizeof(tsn_type))) {
-      return false;
-    }
-    if (!range_check(sid_offset(), sizeof(sid_type))) {
-      return false;
-    }
-    if (!range_check(ssn_offset(), sizeof(ssn_type))) {
-      return false;
-    }
-    if (!range_check(data_offset(), data_size())) {
-      return false;
-    }
-
-    return true;
-  }
-
  public:
   using bits_type = Bits;
   using tsn_type = serialization::PackedInteger<TransmissionSequenceNumber::value_type>;
@@ -57,13 +28,21 @@ class PayloadData : public serialization::PackedStruct {
   using ssn_type = serialization::PackedInteger<StreamSequenceNumber::value_type>;
   using data_type = std::span<uint8_t>;
 
- private:
-  size_t bits_offset() { return 0; }
-  size_t tsn_offset() { return bits_offset() + sizeof(bits_type); }
-  size_t sid_offset() { return tsn_offset() + sizeof(tsn_type); }
-  size_t ssn_offset() { return sid_offset() + sizeof(sid_type); }
-  size_t data_offset() { return ssn_offset() + sizeof(ssn_type); }
-  size_t data_size() { return raw_size() - data_offset(); }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Fixed<bits_type>,
+                                  serialization::field::Fixed<tsn_type>,
+                                  serialization::field::Fixed<sid_type>,
+                                  serialization::field::Fixed<ssn_type>,
+                                  serialization::field::Tail<data_type::value_type>>;
+
+ public:
+  using PackedLayoutStruct::PackedLayoutStruct;
+
+  auto &bits() { return get<0>(); }
+  auto &tsn() { return get<1>(); }
+  auto &sid() { return get<2>(); }
+  auto &ssn() { return get<3>(); }
+  auto data() { return get<4>(); }
 };
 
 }  // namespace detail
@@ -77,14 +56,12 @@ using namespace protocol::detail;
 template <typename... Tags>
 class BufferBuilder<PayloadData, Tags...> {
  public:
-  static constexpr size_t static_size =
-      sizeof(PayloadData::bits_type) + sizeof(PayloadData::tsn_type) +
-      sizeof(PayloadData::sid_type) + sizeof(PayloadData::ssn_type);
+  static constexpr size_t static_size = PayloadData::layout_type::static_size;
 
  public:
   BufferBuilder() : dynamic_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + dynamic_size(); }
 
@@ -6,44 +6,27 @@
 #include "../types/transmission_sequence_number.hpp"
 #include "serialization/buffer_builder.hpp"
 #include "serialization/packed_integer.hpp"
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class SelectiveAcknowledgement : public serialization::PackedStruct {
+class SelectiveAcknowledgement final
+    : public serialization::PackedLayoutStruct<SelectiveAcknowledgement> {
  public:
-  using PackedStruct::PackedStruct;
-
-  auto &cum_tsn_ack() { return jmp_ref<cum_tsn_ack_type>(cum_tsn_ack_offset()); }
-  auto gap_ack_blks() {
-    return gap_ack_blks_type(jmp_ptr<gap_ack_blks_type::value_type>(gap_ack_blks_offset()),
-                             num_gap_ack_blks());
-  }
-
-  bool validate() override {
-    if (!range_check(cum_tsn_ack_offset(), sizeof(cum_tsn_ack_type))) {
-      return false;
-    }
-    if (!range_check(gap_ack_blks_offset(),
-                     sizeof(gap_ack_blks_type::value_type) * num_gap_ack_blks())) {
-      return false;
-    }
+  using cum_tsn_ack_type = serialization::PackedInteger<TransmissionSequenceNumber::value_type>;
+  using gap_ack_blks_type = std::span<GapAckBlock>;
 
-    return true;
-  }
+  using layout_type =
+      serialization::PackedLayout<serialization::field::Fixed<cum_tsn_ack_type>,
+                                  serialization::field::Tail<gap_ack_blks_type::value_type>>;
 
  public:
-  using cum_tsn_ack_type = serialization::PackedInteger<TransmissionSequenceNumber::value_type>;
-  using gap_ack_blks_type = std::span<GapAckBlock>;
+  using PackedLayoutStruct::PackedLayoutStruct;
 
- private:
-  size_t cum_tsn_ack_offset() { return 0; }
-  size_t gap_ack_blks_offset() { return cum_tsn_ack_offset() + sizeof(cum_tsn_ack_type); }
-  size_t num_gap_ack_blks() {
-    return (raw_size() - gap_ack_blks_offset()) / sizeof(gap_ack_blks_type::value_type);
-  }
+  auto &cum_tsn_ack() { return get<0>(); }
+  auto gap_ack_blks() { return get<1>(); }
 };
 
 }  // namespace detail
@@ -57,12 +40,12 @@ using namespace protocol::detail;
 template <typename... Tags>
 class BufferBuilder<SelectiveAcknowledgement, Tags...> {
  public:
-  static constexpr size_t static_size = sizeof(SelectiveAcknowledgement::cum_tsn_ack_type);
+  static constexpr size_t static_size = SelectiveAcknowledgement::layout_type::static_size;
 
  public:
   BufferBuilder() : dynamic_size_(0) {}
 
-  auto build() { return std::vector<uint8_t>(buffer_size()); }
+  auto build() { return BufferPool::acquire(buffer_size()); }
 
   size_t buffer_size() { return static_size + dynamic_size(); }
 
@@ -1,16 +1,18 @@
 #pragma once
 
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class ShutdownAcknowledgement : public serialization::PackedStruct {
+class ShutdownAcknowledgement final
+    : public serialization::PackedLayoutStruct<ShutdownAcknowledgement> {
  public:
-  using PackedStruct::PackedStruct;
+  using layout_type = serialization::PackedLayout<>;
 
-  bool validate() override { return true; }
+ public:
+  using PackedLayoutStruct::PackedLayoutStruct;
 };
 
 }  // namespace detail
@@ -1,16 +1,17 @@
 #pragma once
 
-#include "serialization/packed_struct.hpp"
+#include "serialization/packed_layout.hpp"
 
 namespace protocol {
 
 namespace detail {
 
-class ShutdownAssociation : public serialization::PackedStruct {
+class ShutdownAssociation final : public serialization::PackedLayoutStruct<ShutdownAssociation> {
  public:
-  using PackedStruct::PackedStruct;
+  using layout_type = serialization::PackedLayout<>;
 
-  bool validate() override { return true; }
+ public:
+  using PackedLayoutStruct::PackedLayoutStruct;
 };
 
 }  // namespace detail
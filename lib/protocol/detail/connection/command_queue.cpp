@@ -0,0 +1,106 @@
+#include "command_queue.hpp"
+
+#include <asio/post.hpp>
+
+#include "connection_p.hpp"
+#include "serialization/buffer_pool.hpp"
+#include "stream_p.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+void CommandQueue::push(Command command) {
+  queue_.push(std::move(command));
+
+  if (!scheduled_.exchange(true, std::memory_order_acq_rel)) {
+    asio::post(parent().strand, [parent = parent().shared_from_this()]() {
+      parent->command_queue.drain();
+    });
+  }
+}
+
+void CommandQueue::reset() {}
+
+template <>
+void CommandQueue::handle(command::Abort) {
+  if (parent().state_manager.any_of(Connection::State::Closed)) {
+    return;
+  }
+
+  if (parent().state_manager.none_of(Connection::State::Listen)) {
+    parent().out_control_queue.push(ChunkType::Abort, {});
+
+    parent().network_manager.write_priority_packets();
+  }
+
+  parent().state_manager.set(Connection::State::Closed);
+}
+
+template <>
+void CommandQueue::handle(command::SetReliabilityParams command) {
+  auto& stream_private = parent().stream_manager.get_private(command.stream_identifier);
+
+  stream_private.unordered = command.unordered;
+  stream_private.reliability_type = command.rel_type;
+  stream_private.reliability_value = command.rel_val;
+}
+
+template <>
+void CommandQueue::handle(command::Shutdown) {
+  if (parent().state_manager.any_of(Connection::State::Listen)) {
+    parent().state_manager.set(Connection::State::Closed);
+    return;
+  }
+
+  if (parent().state_manager.none_of(Connection::State::Established)) {
+    return;
+  }
+
+  parent().hibernation_manager.touch();
+
+  if (parent().out_data_queue.empty()) {
+    parent().out_control_queue.push(ChunkType::ShutdownAssociation, {});
+
+    parent().state_manager.set(Connection::State::ShutdownSent);
+  } else {
+    parent().state_manager.set(Connection::State::ShutdownPending);
+  }
+}
+
+template <>
+void CommandQueue::handle(command::Write command) {
+  if (parent().state_manager.any_of(
+          Connection::State::ShutdownPending, Connection::State::ShutdownSent,
+          Connection::State::ShutdownReceived, Connection::State::ShutdownAckSent)) {
+    return;
+  }
+
+  parent().hibernation_manager.touch();
+
+  auto& stream = parent().stream_manager.get_private(command.stream_identifier);
+
+  if (auto* message = std::get_if<std::vector<uint8_t>>(&command.message)) {
+    stream.write(*message);
+
+    serialization::BufferPool::release(std::move(*message));
+  } else {
+    stream.write(*std::get<std::shared_ptr<const std::vector<uint8_t>>>(command.message));
+  }
+}
+
+void CommandQueue::drain() {
+  scheduled_.exchange(false, std::memory_order_acq_rel);
+
+  while (auto command = queue_.pop()) {
+    std::visit([this](auto&& command) { handle(std::move(command)); }, std::move(*command));
+  }
+
+  if (parent().state_manager.none_of(Connection::State::Closed)) {
+    parent().network_manager.write_pending_packets();
+  }
+}
+
+}  // namespace detail
+
+}  // namespace protocol
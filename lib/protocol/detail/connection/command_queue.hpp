@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "api/types/stream_identifier.hpp"
+#include "stream.hpp"
+#include "utils/abstract/iresetable.hpp"
+#include "utils/mpsc_queue.hpp"
+#include "utils/parentable.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+class ConnectionPrivate;
+
+namespace command {
+
+struct Abort {};
+
+struct SetReliabilityParams {
+  StreamIdentifier stream_identifier;
+  bool unordered;
+  Stream::ReliabilityType rel_type;
+  Stream::ReliabilityValue rel_val;
+};
+
+struct Shutdown {};
+
+struct Write {
+  StreamIdentifier stream_identifier;
+  std::variant<std::vector<uint8_t>, std::shared_ptr<const std::vector<uint8_t>>> message;
+};
+
+}  // namespace command
+
+// Public Connection/Stream calls may come from any thread. They are turned into commands which
+// are executed on the connection strand, a batch at a time, followed by a single flush.
+class CommandQueue : public utils::Parentable<ConnectionPrivate>, utils::IResetable {
+ public:
+  using Command = std::variant<command::Abort, command::SetReliabilityParams, command::Shutdown,
+                               command::Write>;
+
+ public:
+  using Parentable::Parentable;
+
+  void push(Command command);
+
+  void reset() override;
+
+ private:
+  void drain();
+
+  template <typename T>
+  void handle(T command);
+
+ private:
+  utils::MpscQueue<Command> queue_;
+  std::atomic<bool> scheduled_ = false;
+};
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -11,6 +11,7 @@ void CongestionManager::acknowledged(size_t bytes, bool cum_tsn_ack_point_advanc
   bytes_outstanding_ -= std::min(bytes_outstanding_, bytes);
 
   if (!cum_tsn_ack_point_advanced) {
+    publish();
     return;
   }
 
@@ -26,6 +27,8 @@ void CongestionManager::acknowledged(size_t bytes, bool cum_tsn_ack_point_advanc
       cwnd_ += parent().packet_builder.mtu();
     }
   }
+
+  publish();
 }
 
 void CongestionManager::enter_fast_recovery(TransmissionSequenceNumber::value_type exit_point) {
@@ -36,6 +39,10 @@ void CongestionManager::enter_fast_recovery(TransmissionSequenceNumber::value_ty
   ssthresh_ = std::max<size_t>(cwnd_ / 2, 4 * parent().packet_builder.mtu());
   cwnd_ = ssthresh_;
   partial_bytes_acked_ = 0;
+
+  ConnectionStatistics::add(parent().statistics.fast_recovery_entries);
+
+  publish();
 }
 
 void CongestionManager::exit_fast_recovery() {
@@ -59,12 +66,18 @@ void CongestionManager::on_long_idle_period() {
 
   cwnd_ = initial_cwnd();
   partial_bytes_acked_ = 0;
+
+  publish();
 }
 
 void CongestionManager::on_retransmission() {
   ssthresh_ = std::max<size_t>(cwnd_ / 2, 4 * parent().packet_builder.mtu());
   cwnd_ = 1 * parent().packet_builder.mtu();
   bytes_outstanding_ = 0;
+
+  ConnectionStatistics::add(parent().statistics.timeouts);
+
+  publish();
 }
 
 void CongestionManager::reset() {
@@ -73,12 +86,16 @@ void CongestionManager::reset() {
   bytes_outstanding_ = 0;
   partial_bytes_acked_ = 0;
   in_fast_recovery_ = false;
+
+  publish();
 }
 
 void CongestionManager::transmitted(size_t bytes) {
   ASSERT(is_transmittable(bytes));
 
   bytes_outstanding_ += bytes;
+
+  publish();
 }
 
 size_t CongestionManager::initial_cwnd() const {
@@ -86,6 +103,12 @@ size_t CongestionManager::initial_cwnd() const {
                   std::max(2 * parent().packet_builder.mtu(), 4380));
 }
 
+void CongestionManager::publish() {
+  ConnectionStatistics::set(parent().statistics.bytes_in_flight, bytes_outstanding_);
+  ConnectionStatistics::set(parent().statistics.cwnd, cwnd_);
+  ConnectionStatistics::set(parent().statistics.ssthresh, ssthresh_);
+}
+
 }  // namespace detail
 
 }  // namespace protocol
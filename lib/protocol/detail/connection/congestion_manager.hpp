@@ -39,6 +39,8 @@ class CongestionManager : public utils::Parentable<ConnectionPrivate>, utils::IR
  private:
   [[nodiscard]] size_t initial_cwnd() const;
 
+  void publish();
+
  private:
   size_t bytes_outstanding_;
   size_t cwnd_;
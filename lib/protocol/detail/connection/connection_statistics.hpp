@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+#include "connection.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+// Live values behind Connection::statistics(). They are only written on the connection strand,
+// so updates are relaxed load/store pairs rather than read-modify-write instructions, and a
+// snapshot can be taken from any thread without synchronizing with the strand.
+struct ConnectionStatistics {
+  static void add(std::atomic<size_t>& counter, size_t value = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+  }
+
+  template <typename T, typename U>
+  static void set(std::atomic<T>& gauge, U value) {
+    gauge.store(static_cast<T>(value), std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (auto* counter :
+         {&abandoned_chunks, &bytes_in_flight, &bytes_received, &bytes_sent, &cwnd,
+          &decrypt_failures, &fast_recovery_entries, &fast_retransmissions, &gap_ack_blocks,
+          &in_flight_chunks, &out_of_order_chunks, &packets_received, &packets_sent,
+          &pending_chunks, &replay_rejections, &retransmissions, &ssthresh, &timeouts}) {
+      set(*counter, 0);
+    }
+
+    set(handshake_time, 0);
+    set(rto, 0);
+    set(rttvar, 0);
+    set(srtt, 0);
+  }
+
+  [[nodiscard]] Connection::Statistics snapshot() const {
+    constexpr auto relaxed = std::memory_order_relaxed;
+
+    return {.abandoned_chunks = abandoned_chunks.load(relaxed),
+            .bytes_in_flight = bytes_in_flight.load(relaxed),
+            .bytes_received = bytes_received.load(relaxed),
+            .bytes_sent = bytes_sent.load(relaxed),
+            .cwnd = cwnd.load(relaxed),
+            .decrypt_failures = decrypt_failures.load(relaxed),
+            .fast_recovery_entries = fast_recovery_entries.load(relaxed),
+            .fast_retransmissions = fast_retransmissions.load(relaxed),
+            .gap_ack_blocks = gap_ack_blocks.load(relaxed),
+            .handshake_time = handshake_time.load(relaxed),
+            .in_flight_chunks = in_flight_chunks.load(relaxed),
+            .out_of_order_chunks = out_of_order_chunks.load(relaxed),
+            .packets_received = packets_received.load(relaxed),
+            .packets_sent = packets_sent.load(relaxed),
+            .pending_chunks = pending_chunks.load(relaxed),
+            .replay_rejections = replay_rejections.load(relaxed),
+            .retransmissions = retransmissions.load(relaxed),
+            .rto = rto.load(relaxed),
+            .rttvar = rttvar.load(relaxed),
+            .srtt = srtt.load(relaxed),
+            .ssthresh = ssthresh.load(relaxed),
+            .timeouts = timeouts.load(relaxed)};
+  }
+
+  std::atomic<size_t> abandoned_chunks;
+  std::atomic<size_t> bytes_in_flight;
+  std::atomic<size_t> bytes_received;
+  std::atomic<size_t> bytes_sent;
+  std::atomic<size_t> cwnd;
+  std::atomic<size_t> decrypt_failures;
+  std::atomic<size_t> fast_recovery_entries;
+  std::atomic<size_t> fast_retransmissions;
+  std::atomic<size_t> gap_ack_blocks;
+  std::atomic<float> handshake_time;
+  std::atomic<size_t> in_flight_chunks;
+  std::atomic<size_t> out_of_order_chunks;
+  std::atomic<size_t> packets_received;
+  std::atomic<size_t> packets_sent;
+  std::atomic<size_t> pending_chunks;
+  std::atomic<size_t> replay_rejections;
+  std::atomic<size_t> retransmissions;
+  std::atomic<uint32_t> rto;
+  std::atomic<float> rttvar;
+  std::atomic<float> srtt;
+  std::atomic<size_t> ssthresh;
+  std::atomic<size_t> timeouts;
+};
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -2,6 +2,7 @@
 
 #include <cstring>
 
+#include "connection_p.hpp"
 #include "crypto/helpers.hpp"
 
 namespace protocol {
@@ -28,6 +29,7 @@ bool CryptoManager::decrypt(std::span<const uint8_t> mac,
                             const serialization::PackedInteger<Nonce>& nonce,
                             std::span<uint8_t> data) {
   if (!replay_.check(nonce)) [[unlikely]] {
+    ConnectionStatistics::add(parent().statistics.replay_rejections);
     return false;
   }
 
@@ -35,6 +37,7 @@ bool CryptoManager::decrypt(std::span<const uint8_t> mac,
 
   if (!crypto::ChaCha20Poly1305::decrypt(data, mac, generate_iv(nonce, decrypt_initial_count_),
                                          key_, {}, data)) [[unlikely]] {
+    ConnectionStatistics::add(parent().statistics.decrypt_failures);
     return false;
   }
 
@@ -14,6 +14,11 @@ namespace detail {
 class ConnectionPrivate;
 
 class CryptoManager : public utils::Parentable<ConnectionPrivate>, utils::IResetable {
+ private:
+  // 32 * 64 bits cover ~2k packets of reordering, while keeping the window at 256 bytes
+  // instead of 1 KiB per connection.
+  static constexpr size_t REPLAY_WINDOW_BLOCKS = 32;
+
  public:
   using Parentable::Parentable;
 
@@ -36,7 +41,7 @@ class CryptoManager : public utils::Parentable<ConnectionPrivate>, utils::IReset
   serialization::pu32 encrypt_initial_count_;
   std::array<uint8_t, crypto::ChaCha20Poly1305::KeyLength> key_;
   Nonce nonce_;
-  AntiReplayWindow<Nonce> replay_;
+  AntiReplayWindow<Nonce, uint64_t, REPLAY_WINDOW_BLOCKS> replay_;
 };
 
 }  // namespace detail
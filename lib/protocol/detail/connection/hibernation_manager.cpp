@@ -0,0 +1,86 @@
+#include "hibernation_manager.hpp"
+
+#include "connection_p.hpp"
+#include "utils/debug/assert.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+void HibernationManager::hibernate() {
+  ASSERT(!hibernated_);
+
+  // Everything a quiescent association needs to resume (keys, TSN/SSN counters, replay window,
+  // peer endpoint) is plain data inside the managers. What is released here is the state that
+  // only matters while traffic flows: armed timers, queue capacity and the priority queue.
+  parent().timer_manager.stop_all();
+  parent().out_control_queue.shrink_to_fit();
+  parent().network_manager.shrink_to_fit();
+
+  hibernated_ = true;
+}
+
+std::optional<std::chrono::milliseconds> HibernationManager::interval() const { return interval_; }
+
+bool HibernationManager::is_hibernated() const { return hibernated_; }
+
+bool HibernationManager::is_idle() const {
+  if (!interval_.has_value() || hibernated_) {
+    return false;
+  }
+
+  if (parent().state_manager.none_of(Connection::State::Established)) {
+    return false;
+  }
+
+  if (!parent().out_control_queue.empty() || !parent().out_data_queue.empty()) {
+    return false;
+  }
+
+  if (parent().timer_manager.is_started<TimerManager::TimerId::Ack>() ||
+      parent().timer_manager.is_started<TimerManager::TimerId::Rtx>()) {
+    return false;
+  }
+
+  return std::chrono::steady_clock::now() - last_activity_ >= *interval_;
+}
+
+void HibernationManager::reset() {
+  hibernated_ = false;
+  interval_.reset();
+  last_activity_ = {};
+}
+
+void HibernationManager::set_interval(std::optional<std::chrono::milliseconds> interval) {
+  if (interval.has_value() && *interval <= std::chrono::milliseconds::zero()) {
+    interval.reset();
+  }
+
+  interval_ = interval;
+}
+
+void HibernationManager::touch() {
+  last_activity_ = std::chrono::steady_clock::now();
+
+  if (hibernated_) [[unlikely]] {
+    wake();
+  }
+}
+
+void HibernationManager::wake() {
+  hibernated_ = false;
+
+  if (parent().state_manager.none_of(Connection::State::Established)) {
+    return;
+  }
+
+  if (parent().out_data_queue.empty()) {
+    parent().timer_manager.start<TimerManager::TimerId::Heartbeat>();
+  }
+
+  parent().timer_manager.start<TimerManager::TimerId::Hibernate>();
+}
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include "utils/abstract/iresetable.hpp"
+#include "utils/parentable.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+class ConnectionPrivate;
+
+class HibernationManager : public utils::Parentable<ConnectionPrivate>, utils::IResetable {
+ public:
+  using Parentable::Parentable;
+
+  void hibernate();
+
+  [[nodiscard]] std::optional<std::chrono::milliseconds> interval() const;
+
+  [[nodiscard]] bool is_hibernated() const;
+
+  [[nodiscard]] bool is_idle() const;
+
+  void reset() override;
+
+  void set_interval(std::optional<std::chrono::milliseconds> interval);
+
+  void touch();
+
+ private:
+  void wake();
+
+ private:
+  bool hibernated_;
+  std::optional<std::chrono::milliseconds> interval_;
+  std::chrono::steady_clock::time_point last_activity_;
+};
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -48,15 +48,18 @@ std::vector<GapAckBlock> InDataQueue::get_gap_ack_blocks() {
     }
   }
 
+  ConnectionStatistics::add(parent().statistics.gap_ack_blocks, result.size());
+
   return result;
 }
 
 TransmissionSequenceNumber::value_type InDataQueue::peer_last_tsn() const { return peer_last_tsn_; }
 
-InDataQueue::PushReturnValue InDataQueue::push(PayloadData payload_data) {
+InDataQueue::PushReturnValue InDataQueue::push(PayloadData payload_data,
+                                               const DatagramSlice& datagram) {
   storage_type::iterator pos;
 
-  if (auto opt = insert_fragment(payload_data)) {
+  if (auto opt = insert_fragment(payload_data, datagram)) {
     pos = *opt;
   } else {
     return {.success = false, .has_packet_loss = false, .user_data = {}};
@@ -64,10 +67,23 @@ InDataQueue::PushReturnValue InDataQueue::push(PayloadData payload_data) {
 
   shift_peer_last_tsn(pos);
 
-  return {
-      .success = true,
-      .has_packet_loss = TransmissionSequenceNumber::Greater{}(payload_data.tsn(), peer_last_tsn_),
-      .user_data = reassemble_fragments(pos)};
+  const bool has_packet_loss =
+      TransmissionSequenceNumber::Greater{}(payload_data.tsn(), peer_last_tsn_);
+
+  const auto tsn = payload_data.tsn();
+
+  auto user_data = reassemble_fragments(pos);
+
+  // A fragment outliving the push would pin the whole block of its datagram.
+  if (auto iterator = storage_.find(tsn); iterator != storage_.end()) {
+    auto& data = iterator->second.data;
+
+    data = DatagramSlice::copy({data.data(), data.size()});
+  }
+
+  ConnectionStatistics::set(parent().statistics.out_of_order_chunks, storage_.size());
+
+  return {.success = true, .has_packet_loss = has_packet_loss, .user_data = std::move(user_data)};
 }
 
 void InDataQueue::reset() {
@@ -120,7 +136,7 @@ std::optional<InDataQueue::storage_type::iterator> InDataQueue::find_ending_frag
 }
 
 std::optional<InDataQueue::storage_type::iterator> InDataQueue::insert_fragment(
-    PayloadData payload_data) {
+    PayloadData payload_data, const DatagramSlice& datagram) {
   if (TransmissionSequenceNumber::LessEqual{}(payload_data.tsn(), peer_last_tsn_)) {
     return std::nullopt;
   }
@@ -138,10 +154,10 @@ std::optional<InDataQueue::storage_type::iterator> InDataQueue::insert_fragment(
     }
   }
 
-  storage_type::mapped_type value{.data = {}, .to_be_deleted = false};
-
-  value.data.resize(payload_data.raw_size());
-  std::memcpy(value.data.data(), payload_data.raw_data(), value.data.size());
+  storage_type::mapped_type value{
+      .data = datagram.slice({static_cast<const uint8_t*>(payload_data.raw_data()),
+                              payload_data.raw_size()}),
+      .to_be_deleted = false};
 
   return storage_.emplace_hint(pos, std::piecewise_construct,
                                std::forward_as_tuple(payload_data.tsn()),
@@ -174,7 +190,7 @@ std::optional<std::vector<uint8_t>> InDataQueue::reassemble_fragments(storage_ty
   size_t data_size = 0;
 
   for (auto iterator = itbeg; iterator != itend; ++iterator) {
-    data_size += iterator->second.data.size();
+    data_size += PayloadData(iterator->second.data).data().size();
   }
 
   std::vector<uint8_t> user_data(data_size);
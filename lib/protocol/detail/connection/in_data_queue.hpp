@@ -9,6 +9,7 @@
 #include "api/types/stream_identifier.hpp"
 #include "api/types/stream_sequence_number.hpp"
 #include "api/types/transmission_sequence_number.hpp"
+#include "detail/datagram_pool.hpp"
 #include "utils/abstract/iresetable.hpp"
 #include "utils/parentable.hpp"
 
@@ -28,7 +29,7 @@ class InDataQueue : public utils::Parentable<ConnectionPrivate>, utils::IResetab
     std::optional<std::vector<uint8_t>> user_data;
   };
   struct StorageValue {
-    std::vector<uint8_t> data;
+    DatagramSlice data;
     bool to_be_deleted;
   };
 
@@ -45,7 +46,9 @@ class InDataQueue : public utils::Parentable<ConnectionPrivate>, utils::IResetab
 
   [[nodiscard]] TransmissionSequenceNumber::value_type peer_last_tsn() const;
 
-  PushReturnValue push(PayloadData payload_data);
+  // datagram owns the memory payload_data points into. A fragment still held once the push returns
+  // is copied out of it, so stored fragments never pin a datagram.
+  PushReturnValue push(PayloadData payload_data, const DatagramSlice& datagram);
 
   void reset() override;
 
@@ -58,7 +61,8 @@ class InDataQueue : public utils::Parentable<ConnectionPrivate>, utils::IResetab
 
   [[nodiscard]] size_t max_gap_ack_blocks() const;
 
-  std::optional<storage_type::iterator> insert_fragment(PayloadData payload_data);
+  std::optional<storage_type::iterator> insert_fragment(PayloadData payload_data,
+                                                        const DatagramSlice& datagram);
 
   std::optional<std::vector<uint8_t>> reassemble_fragments(storage_type::iterator pos);
 
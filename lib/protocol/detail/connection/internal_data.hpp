@@ -1,9 +1,13 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <optional>
 
 #include "connection.hpp"
+#include "crypto/helpers.hpp"
 #include "crypto/sidhp434_compressed.hpp"
 #include "detail/connection/api/types/connection_id.hpp"
 
@@ -11,13 +15,25 @@ namespace protocol {
 
 namespace detail {
 
-struct InternalData {
-  ConnectionID connection_id;
+// Only needed until the association is established, so it is allocated on associate() and
+// released (and wiped) as soon as the connection leaves the handshake states.
+struct HandshakeData {
+  ~HandshakeData() {
+    crypto::Helpers::memzero(secret_key_b.data(), secret_key_b.size());
+    crypto::Helpers::memzero(temp_agreed.data(), temp_agreed.size());
+  }
+
   std::array<uint8_t, crypto::SIDHp434_compressed::SecretKeyBLength> secret_key_b;
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
   std::optional<std::vector<uint8_t>> stored_init;
   std::optional<std::vector<uint8_t>> stored_init_ack;
   std::array<uint8_t, crypto::SIDHp434_compressed::SharedSecretLength> temp_agreed;
-  Connection::Type type;
+};
+
+struct InternalData {
+  ConnectionID connection_id;
+  std::unique_ptr<HandshakeData> handshake;
+  std::atomic<Connection::Type> type;
 };
 
 }  // namespace detail
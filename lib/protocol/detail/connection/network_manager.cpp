@@ -4,7 +4,6 @@
 #include "detail/async_recursive_read_datagram.hpp"
 #include "detail/async_send_datagram.hpp"
 #include "detail/connection/api/structures/packet.hpp"
-#include "detail/send_datagram.hpp"
 #include "utils/debug/assert.hpp"
 
 namespace protocol {
@@ -14,12 +13,31 @@ namespace detail {
 bool NetworkManager::is_receiving() const { return receiving_; }
 
 void NetworkManager::reset() {
+  impairment_queue_.reset();
   receiving_ = false;
+  priority_queue_.reset();
   rx_socket_.reset();
   tx_endpoint_.reset();
   tx_socket_.reset();
 }
 
+void NetworkManager::set_impairment(std::optional<Connection::NetworkImpairment> impairment) {
+  if (!impairment.has_value()) [[likely]] {
+    impairment_queue_.reset();
+    return;
+  }
+
+  impairment_queue_ = std::make_shared<ImpairmentQueue>(
+      parent().strand, *impairment,
+      [weak_parent = parent().weak_from_this()](std::vector<uint8_t>&& packet) {
+        if (auto parent = weak_parent.lock()) [[likely]] {
+          if (parent->network_manager.tx_socket_ != nullptr) [[likely]] {
+            parent->network_manager.send(std::move(packet));
+          }
+        }
+      });
+}
+
 void NetworkManager::set_rx_socket(
     std::shared_ptr<asio::generic::datagram_protocol::socket> socket) {
   if (socket != nullptr) {
@@ -42,6 +60,13 @@ void NetworkManager::set_tx_socket(
   }
 
   tx_socket_ = std::move(socket);
+
+  priority_queue_.reset();
+}
+
+void NetworkManager::shrink_to_fit() {
+  // Datagrams it still has to send keep it alive until they are sent.
+  priority_queue_.reset();
 }
 
 void NetworkManager::start_receive() {
@@ -67,42 +92,50 @@ void NetworkManager::stop_receive() {
   receiving_ = false;
 }
 
-template <>
-void NetworkManager::write_pending_packets<false>() {
+void NetworkManager::write_pending_packets() {
   ASSERT(tx_socket_ != nullptr);
 
   auto packets = gather_outbound();
 
   for (auto& packet : packets) {
-    send_datagram<asio::generic::datagram_protocol>(*tx_socket_, tx_endpoint_, std::move(packet));
+    if (impairment_queue_ != nullptr) [[unlikely]] {
+      impairment_queue_->push(std::move(packet));
+    } else {
+      send(std::move(packet));
+    }
   }
 }
 
-template <>
-void NetworkManager::write_pending_packets<true>() {
+// Terminal chunks bypass the impairment, they have to leave before the connection is reset.
+void NetworkManager::write_priority_packets() {
   ASSERT(tx_socket_ != nullptr);
 
-  auto packets = gather_outbound();
+  if (priority_queue_ == nullptr) {
+    priority_queue_ = std::make_shared<PriorityDatagramQueue>(parent().strand, tx_socket_);
+  }
+
+  auto packets = parent().out_control_queue.gather_unsent_packets();
 
   for (auto& packet : packets) {
-    async_send_datagram<asio::generic::datagram_protocol>(*tx_socket_, tx_endpoint_,
-                                                          std::move(packet));
+    ConnectionStatistics::add(parent().statistics.bytes_sent, packet.size());
+    ConnectionStatistics::add(parent().statistics.packets_sent);
+
+    priority_queue_->push(tx_endpoint_, std::move(packet));
   }
 }
 
 void NetworkManager::async_receive_rx_socket_handler(
-    ConnectionPrivate& parent, std::vector<uint8_t> data,
+    ConnectionPrivate& parent, DatagramSlice data,
     asio::generic::datagram_protocol::endpoint endpoint) {
-  std::unique_lock lock(parent.mutex);
-
   if (parent.network_manager.tx_socket_->native_handle() ==
       parent.network_manager.rx_socket_->native_handle()) {
     parent.network_manager.tx_endpoint_ = std::move(endpoint);
   }
 
-  if (!parent.packet_handler.handle(Packet(data))) {
-    return;
-  }
+  ConnectionStatistics::add(parent.statistics.bytes_received, data.size());
+  ConnectionStatistics::add(parent.statistics.packets_received);
+
+  parent.packet_handler.handle(data);
 }
 
 std::list<std::vector<uint8_t>> NetworkManager::gather_outbound() {
@@ -130,6 +163,14 @@ std::list<std::vector<uint8_t>> NetworkManager::gather_outbound() {
   return result;
 }
 
+void NetworkManager::send(std::vector<uint8_t>&& packet) {
+  ConnectionStatistics::add(parent().statistics.bytes_sent, packet.size());
+  ConnectionStatistics::add(parent().statistics.packets_sent);
+
+  async_send_datagram<asio::generic::datagram_protocol>(*tx_socket_, tx_endpoint_,
+                                                        std::move(packet));
+}
+
 }  // namespace detail
 
 }  // namespace protocol
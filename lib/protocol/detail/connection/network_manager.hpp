@@ -5,6 +5,10 @@
 #include <memory>
 #include <optional>
 
+#include "connection.hpp"
+#include "detail/datagram_pool.hpp"
+#include "detail/impairment_queue.hpp"
+#include "detail/priority_datagram_queue.hpp"
 #include "utils/abstract/iresetable.hpp"
 #include "utils/parentable.hpp"
 
@@ -22,30 +26,40 @@ class NetworkManager : public utils::Parentable<ConnectionPrivate>, utils::IRese
 
   void reset() override;
 
+  void set_impairment(std::optional<Connection::NetworkImpairment> impairment);
+
   void set_rx_socket(std::shared_ptr<asio::generic::datagram_protocol::socket> socket);
 
   void set_tx_endpoint(std::optional<asio::generic::datagram_protocol::endpoint> endpoint);
 
   void set_tx_socket(std::shared_ptr<asio::generic::datagram_protocol::socket> socket);
 
+  // Releases the priority queue, it is created again for the next terminal chunks.
+  void shrink_to_fit();
+
   void start_receive();
 
   void stop_receive();
 
-  template <bool Async = true>
   void write_pending_packets();
 
+  // Sends the pending control chunks through the priority queue, without blocking and ahead of
+  // any queued data. Meant for the terminal chunks sent right before the connection closes.
+  void write_priority_packets();
+
  private:
-  static void async_receive_rx_socket_handler(ConnectionPrivate& parent, std::vector<uint8_t> data,
+  static void async_receive_rx_socket_handler(ConnectionPrivate& parent, DatagramSlice data,
                                               asio::generic::datagram_protocol::endpoint endpoint);
 
  private:
   std::list<std::vector<uint8_t>> gather_outbound();
 
-  void write(std::vector<uint8_t> data, bool async);
+  void send(std::vector<uint8_t>&& packet);
 
  private:
+  std::shared_ptr<ImpairmentQueue> impairment_queue_;
   bool receiving_;
+  std::shared_ptr<PriorityDatagramQueue> priority_queue_;
   std::shared_ptr<asio::generic::datagram_protocol::socket> rx_socket_;
   std::optional<asio::generic::datagram_protocol::endpoint> tx_endpoint_;
   std::shared_ptr<asio::generic::datagram_protocol::socket> tx_socket_;
@@ -84,6 +84,8 @@ void OutControlQueue::push(ChunkType type, std::vector<uint8_t> data) {
 
 void OutControlQueue::reset() { storage_.clear(); }
 
+void OutControlQueue::shrink_to_fit() { storage_.shrink_to_fit(); }
+
 }  // namespace detail
 
 }  // namespace protocol
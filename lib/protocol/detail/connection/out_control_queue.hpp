@@ -37,6 +37,8 @@ struct OutControlQueue : public utils::Parentable<ConnectionPrivate>, utils::IRe
 
   void reset() override;
 
+  void shrink_to_fit();
+
  private:
   storage_type storage_;
 };
@@ -26,11 +26,11 @@ size_t OutDataQueue::acknowledge(TransmissionSequenceNumber::value_type cum_tsn_
 
     cum_tsn_ack_point_ = payload_data.tsn();
 
-    if (iterator->acked) {
-      continue;
+    if (!iterator->acked) {
+      bytes_acked += mark_as_acked(*iterator);
     }
 
-    bytes_acked += mark_as_acked(*iterator);
+    serialization::BufferPool::release(std::move(iterator->data));
   }
 
   if (TransmissionSequenceNumber::Less{}(advanced_peer_tsn_ack_point_, cum_tsn_ack_point_)) {
@@ -41,6 +41,8 @@ size_t OutDataQueue::acknowledge(TransmissionSequenceNumber::value_type cum_tsn_
     will_retransmit_fast_ = true;
   }
 
+  publish();
+
   return bytes_acked;
 }
 
@@ -174,6 +176,8 @@ std::list<std::vector<uint8_t>> OutDataQueue::gather_fast_retransmission_packets
     input.emplace_back(ChunkType::PayloadData, iterator->data);
   }
 
+  ConnectionStatistics::add(parent().statistics.fast_retransmissions, input.size());
+
   return parent().packet_builder.build(std::move(input));
 }
 
@@ -205,6 +209,8 @@ std::list<std::vector<uint8_t>> OutDataQueue::gather_packets_to_retransmit() {
     input.emplace_back(ChunkType::PayloadData, iterator->data);
   }
 
+  ConnectionStatistics::add(parent().statistics.retransmissions, input.size());
+
   return parent().packet_builder.build(std::move(input));
 }
 
@@ -233,6 +239,8 @@ std::list<std::vector<uint8_t>> OutDataQueue::gather_unsent_packets() {
     input.emplace_back(ChunkType::PayloadData, iterator->data);
   }
 
+  publish();
+
   return parent().packet_builder.build(std::move(input));
 }
 
@@ -285,6 +293,8 @@ void OutDataQueue::push(std::vector<uint8_t> data) {
   ASSERT(payload_data.validate());
 
   storage_send_.emplace_back(StorageValue{false, false, false, 0, 0, -1, std::move(data)});
+
+  ConnectionStatistics::set(parent().statistics.pending_chunks, storage_send_.size());
 }
 
 void OutDataQueue::reset() {
@@ -296,6 +306,8 @@ void OutDataQueue::reset() {
   storage_send_.clear();
   will_retransmit_fast_ = false;
   will_send_forward_tsn_ = false;
+
+  publish();
 }
 
 void OutDataQueue::check_partial_reliability_status(storage_type::iterator iterator) {
@@ -329,6 +341,8 @@ void OutDataQueue::check_partial_reliability_status(storage_type::iterator itera
   for (; iterator != storage_sent_.end(); ++iterator) {
     iterator->acked = iterator->abandoned = true;
 
+    ConnectionStatistics::add(parent().statistics.abandoned_chunks);
+
     PayloadData payload_data(iterator->data);
 
     parent().congestion_manager.acknowledged(payload_data.data().size(), false);
@@ -357,6 +371,11 @@ std::vector<ForwardTsnStream> OutDataQueue::get_forward_tsn_streams() {
   return result;
 }
 
+void OutDataQueue::publish() {
+  ConnectionStatistics::set(parent().statistics.in_flight_chunks, storage_sent_.size());
+  ConnectionStatistics::set(parent().statistics.pending_chunks, storage_send_.size());
+}
+
 size_t OutDataQueue::mark_as_acked(StorageValue& sv) {
   sv.acked = true;
 
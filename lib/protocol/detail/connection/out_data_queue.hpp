@@ -79,6 +79,8 @@ struct OutDataQueue : public utils::Parentable<ConnectionPrivate>, utils::IReset
 
   size_t mark_as_acked(StorageValue& sv);
 
+  void publish();
+
  private:
   TransmissionSequenceNumber::value_type advanced_peer_tsn_ack_point_;
   TransmissionSequenceNumber::value_type cum_tsn_ack_point_;
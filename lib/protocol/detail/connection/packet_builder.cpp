@@ -135,16 +135,20 @@ std::vector<uint8_t> PacketBuilder::build_chunk_list(std::list<std::vector<uint8
 
   chunk_list.size() = size;
 
-  size_t n = 0;
+  auto chunk_data_iterator = chunk_list.begin();
 
   for (auto iterator = chunks.begin(); size > 0; --size, iterator = chunks.erase(iterator)) {
     ASSERT(iterator != chunks.end());
 
-    auto& chunk_data = chunk_list.chunk_data(n++);
+    auto& chunk_data = *chunk_data_iterator;
 
     chunk_data.size() = iterator->size();
 
     utils::span::copy<uint8_t>(chunk_data, *iterator);
+
+    serialization::BufferPool::release(std::move(*iterator));
+
+    ++chunk_data_iterator;
   }
 
   ASSERT(chunk_list.validate());
@@ -161,6 +165,8 @@ std::vector<uint8_t> PacketBuilder::build_encrypted_packet_data(
 
   utils::span::copy<uint8_t>(encrypted_packet_data.data(), packet_data);
 
+  serialization::BufferPool::release(std::move(packet_data));
+
   parent().crypto_manager.encrypt(encrypted_packet_data.mac(), encrypted_packet_data.nonce(),
                                   encrypted_packet_data.data());
 
@@ -180,6 +186,8 @@ std::vector<uint8_t> PacketBuilder::build_packet(std::vector<uint8_t>&& packet_d
 
   utils::span::copy<uint8_t>(packet.data(), packet_data);
 
+  serialization::BufferPool::release(std::move(packet_data));
+
   ASSERT(packet.validate());
 
   return buffer;
@@ -62,21 +62,20 @@ void PacketHandler::handle(Initiation initiation) {
     return;
   }
 
-  if (!parent().internal_data.stored_init_ack.has_value()) {
-    crypto::Helpers::memzero(parent().internal_data.temp_agreed.data(),
-                             parent().internal_data.temp_agreed.size());
+  auto& handshake = *parent().internal_data.handshake;
 
-    crypto::SIDHp434_compressed::agree_B(parent().internal_data.temp_agreed,
-                                         parent().internal_data.secret_key_b,
+  if (!handshake.stored_init_ack.has_value()) {
+    crypto::Helpers::memzero(handshake.temp_agreed.data(), handshake.temp_agreed.size());
+
+    crypto::SIDHp434_compressed::agree_B(handshake.temp_agreed, handshake.secret_key_b,
                                          initiation.public_key_a());
 
-    crypto::Helpers::memzero(parent().internal_data.secret_key_b.data(),
-                             parent().internal_data.secret_key_b.size());
+    crypto::Helpers::memzero(handshake.secret_key_b.data(), handshake.secret_key_b.size());
 
     std::array<uint8_t, crypto::SHA3_256::DigestSize> public_key_b_mac;
 
-    crypto::SHA3_MAC<crypto::SHA3_256>::compute(
-        public_key_b_mac, parent().internal_data.temp_agreed, initiation.public_key_b());
+    crypto::SHA3_MAC<crypto::SHA3_256>::compute(public_key_b_mac, handshake.temp_agreed,
+                                                initiation.public_key_b());
 
     if (!crypto::Helpers::memcmp(public_key_b_mac.data(), initiation.public_key_b_mac().data(),
                                  public_key_b_mac.size())) [[unlikely]] {
@@ -102,11 +101,10 @@ void PacketHandler::handle(Initiation initiation) {
 
     crypto::SIDHp434_compressed::generate_keypair_A(init_ack.public_key_a(), secret_key_a);
 
-    crypto::SHA3_MAC<crypto::SHA3_256>::compute(
-        init_ack.public_key_a_mac(), parent().internal_data.temp_agreed, init_ack.public_key_a());
+    crypto::SHA3_MAC<crypto::SHA3_256>::compute(init_ack.public_key_a_mac(), handshake.temp_agreed,
+                                                init_ack.public_key_a());
 
-    crypto::Helpers::memzero(parent().internal_data.temp_agreed.data(),
-                             parent().internal_data.temp_agreed.size());
+    crypto::Helpers::memzero(handshake.temp_agreed.data(), handshake.temp_agreed.size());
 
     std::array<uint8_t, crypto::SIDHp434_compressed::SharedSecretLength> agreed;
 
@@ -118,13 +116,12 @@ void PacketHandler::handle(Initiation initiation) {
 
     crypto::Helpers::memzero(agreed.data(), agreed.size());
 
-    parent().internal_data.stored_init_ack = std::move(buffer);
+    handshake.stored_init_ack = std::move(buffer);
 
     parent().state_manager.set(Connection::State::InitReceived);
   }
 
-  parent().out_control_queue.push(ChunkType::InitiationAcknowledgement,
-                                  *parent().internal_data.stored_init_ack);
+  parent().out_control_queue.push(ChunkType::InitiationAcknowledgement, *handshake.stored_init_ack);
 }
 
 template <>
@@ -146,13 +143,14 @@ void PacketHandler::handle(InitiationAcknowledgement initiation_ack) {
 
   parent().internal_data.connection_id = initiation_ack.connection_id();
 
+  auto& handshake = *parent().internal_data.handshake;
+
   std::array<uint8_t, crypto::SHA3_256::DigestSize> public_key_a_mac;
 
-  crypto::SHA3_MAC<crypto::SHA3_256>::compute(public_key_a_mac, parent().internal_data.temp_agreed,
+  crypto::SHA3_MAC<crypto::SHA3_256>::compute(public_key_a_mac, handshake.temp_agreed,
                                               initiation_ack.public_key_a());
 
-  crypto::Helpers::memzero(parent().internal_data.temp_agreed.data(),
-                           parent().internal_data.temp_agreed.size());
+  crypto::Helpers::memzero(handshake.temp_agreed.data(), handshake.temp_agreed.size());
 
   if (!crypto::Helpers::memcmp(public_key_a_mac.data(), initiation_ack.public_key_a_mac().data(),
                                public_key_a_mac.size())) [[unlikely]] {
@@ -162,11 +160,10 @@ void PacketHandler::handle(InitiationAcknowledgement initiation_ack) {
 
   std::array<uint8_t, crypto::SIDHp434_compressed::SharedSecretLength> agreed;
 
-  crypto::SIDHp434_compressed::agree_B(agreed, parent().internal_data.secret_key_b,
+  crypto::SIDHp434_compressed::agree_B(agreed, handshake.secret_key_b,
                                        initiation_ack.public_key_a());
 
-  crypto::Helpers::memzero(parent().internal_data.secret_key_b.data(),
-                           parent().internal_data.secret_key_b.size());
+  crypto::Helpers::memzero(handshake.secret_key_b.data(), handshake.secret_key_b.size());
 
   crypto::SHAKE256::hash(parent().crypto_manager.key_buffer(), agreed);
 
@@ -207,7 +204,7 @@ void PacketHandler::handle(PayloadData payload_data) {
     return;
   }
 
-  auto ret_val = parent().in_data_queue.push(payload_data);
+  auto ret_val = parent().in_data_queue.push(payload_data, *datagram_);
 
   if (!ret_val.success || ret_val.has_packet_loss) {
     parent().ack_manager.trigger_immediate_ack();
@@ -359,6 +356,8 @@ void PacketHandler::handle(ShutdownAcknowledgement shutdown_acknowledgement) {
 
   parent().out_control_queue.push(ChunkType::ShutdownComplete, {});
 
+  parent().network_manager.write_priority_packets();
+
   parent().state_manager.set(Connection::State::Closed);
 }
 
@@ -384,10 +383,9 @@ void PacketHandler::handle(ForwardCumulativeTSN forward_cumulative_tsn) {
   //
 }
 
-template <>
-void PacketHandler::handle(Chunk chunk) {
+bool PacketHandler::handle(Chunk chunk) {
   if (!chunk.validate()) [[unlikely]] {
-    return;
+    return false;
   }
 
   switch (chunk.type()) {
@@ -428,24 +426,35 @@ void PacketHandler::handle(Chunk chunk) {
       handle(ForwardCumulativeTSN(chunk.data()));
       break;
   }
+
+  // Heartbeats only probe the path, answering them does not keep an idle connection awake.
+  return chunk.type() != ChunkType::HeartbeatRequest &&
+         chunk.type() != ChunkType::HeartbeatAcknowledgement;
 }
 
-template <>
-void PacketHandler::handle(ChunkList chunk_list) {
+void PacketHandler::handle(const ChunkList& chunk_list) {
   if (!chunk_list.validate()) [[unlikely]] {
     return;
   }
 
-  for (size_t i = 0; i != chunk_list.size(); ++i) {
-    handle(Chunk(chunk_list.chunk_data(i)));
+  bool active = false;
+
+  for (auto& chunk_data : chunk_list) {
+    active |= handle(Chunk(chunk_data));
   }
 
   parent().ack_manager.commit();
 
   parent().network_manager.write_pending_packets();
+
+  if (active) {
+    parent().hibernation_manager.touch();
+  }
 }
 
-bool PacketHandler::handle(Packet packet) {
+bool PacketHandler::handle(const DatagramSlice& datagram) {
+  Packet packet(datagram);
+
   if (!packet.validate()) [[unlikely]] {
     return false;
   }
@@ -475,8 +484,12 @@ bool PacketHandler::handle(Packet packet) {
     data = packet.data();
   }
 
+  datagram_ = &datagram;
+
   handle(ChunkList(data));
 
+  datagram_ = nullptr;
+
   return true;
 }
 
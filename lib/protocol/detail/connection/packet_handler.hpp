@@ -7,21 +7,34 @@ namespace protocol {
 
 namespace detail {
 
+class Chunk;
+
+class ChunkList;
+
 class ConnectionPrivate;
 
-class Packet;
+class DatagramSlice;
 
 class PacketHandler : public utils::Parentable<ConnectionPrivate>, utils::IResetable {
  public:
   using Parentable::Parentable;
 
-  bool handle(Packet packet);
+  bool handle(const DatagramSlice& datagram);
 
   void reset() override;
 
  private:
   template <typename T>
   void handle(T);
+
+  // Returns whether the chunk was valid and counts as activity of the peer.
+  bool handle(Chunk chunk);
+
+  void handle(const ChunkList& chunk_list);
+
+ private:
+  // Datagram being handled, parsed chunks keep slices of it.
+  const DatagramSlice* datagram_ = nullptr;
 };
 
 }  // namespace detail
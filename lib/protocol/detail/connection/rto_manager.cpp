@@ -2,6 +2,8 @@
 
 #include <algorithm>
 
+#include "connection_p.hpp"
+
 namespace protocol {
 
 namespace detail {
@@ -24,7 +26,11 @@ RtoManager::RtoManager(parent_type& parent)
       rto_max_(RTO_MAX_DEFAULT),
       rto_min_(RTO_MIN_DEFAULT) {}
 
-void RtoManager::backoff_rto() { rto_ = std::min(rto_ * 2, rto_max_); }
+void RtoManager::backoff_rto() {
+  rto_ = std::min(rto_ * 2, rto_max_);
+
+  publish();
+}
 
 RtoManager::Rto RtoManager::rto() const { return rto_; }
 
@@ -48,12 +54,16 @@ void RtoManager::recalculate(Rtt rtt) {
   }
 
   rto_ = std::clamp<Rto>(srtt_ + 4 * rttvar_, rto_min_, rto_max_);
+
+  publish();
 }
 
 void RtoManager::reset() {
   rto_ = rto_initial_;
   rttvar_ = 0;
   srtt_ = 0;
+
+  publish();
 }
 
 void RtoManager::set_rto_alpha(RtoExpDivisor rto_alpha) { rto_alpha_ = rto_alpha; }
@@ -66,6 +76,12 @@ void RtoManager::set_rto_max(Rto rto_max) { rto_max_ = rto_max; }
 
 void RtoManager::set_rto_min(Rto rto_min) { rto_min_ = rto_min; }
 
+void RtoManager::publish() {
+  ConnectionStatistics::set(parent().statistics.rto, rto_);
+  ConnectionStatistics::set(parent().statistics.rttvar, rttvar_);
+  ConnectionStatistics::set(parent().statistics.srtt, srtt_);
+}
+
 }  // namespace detail
 
 }  // namespace protocol
@@ -50,6 +50,9 @@ class RtoManager : public utils::Parentable<ConnectionPrivate>, utils::IResetabl
 
   void set_rto_min(Rto rto_min);
 
+ private:
+  void publish();
+
  private:
   Rto rto_;
   RtoExpDivisor rto_alpha_;
@@ -6,15 +6,25 @@ namespace protocol {
 
 namespace detail {
 
+bool StateManager::claim() {
+  auto expected = Connection::State::Closed;
+
+  return state_.compare_exchange_strong(expected, Connection::State::Listen,
+                                        std::memory_order_acq_rel);
+}
+
 Connection::State StateManager::get() const { return state_; }
 
-void StateManager::reset() { state_ = Connection::State::Closed; }
+// The connection is either new or claimed by associate(), which sets the state itself.
+void StateManager::reset() {}
 
 template <>
 void StateManager::handle<Connection::State::Closed>() {
   parent().network_manager.stop_receive();
   parent().timer_manager.stop_all();
 
+  parent().internal_data.handshake.reset();
+
   parent().self.reset();
 }
 
@@ -33,11 +43,24 @@ void StateManager::handle<Connection::State::InitReceived>() {
 
 template <>
 void StateManager::handle<Connection::State::Established>() {
+  if (const auto& handshake = parent().internal_data.handshake) [[likely]] {
+    ConnectionStatistics::set(parent().statistics.handshake_time,
+                              std::chrono::duration<float, std::milli>(
+                                  std::chrono::steady_clock::now() - handshake->start)
+                                  .count());
+  }
+
+  parent().internal_data.handshake.reset();
+
   parent().network_manager.write_pending_packets();
 
   if (parent().out_data_queue.empty()) {
     parent().timer_manager.start<TimerManager::TimerId::Heartbeat>();
   }
+
+  parent().hibernation_manager.touch();
+
+  parent().timer_manager.start<TimerManager::TimerId::Hibernate>();
 }
 
 template <>
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 #include "connection.hpp"
 #include "utils/abstract/iresetable.hpp"
 #include "utils/parentable.hpp"
@@ -19,14 +21,20 @@ class StateManager : public utils::Parentable<ConnectionPrivate>, utils::IReseta
 
   template <StateConcept... States>
   bool any_of(States&&... states) const {
-    return ((state_ == states) || ...);
+    const auto state = state_.load(std::memory_order_relaxed);
+    return ((state == states) || ...);
   }
 
+  // Moves a closed connection to Listen without notifying, ahead of its association on the
+  // strand. Returns false when the connection is not closed.
+  [[nodiscard]] bool claim();
+
   [[nodiscard]] Connection::State get() const;
 
   template <StateConcept... States>
   bool none_of(States&&... states) const {
-    return ((state_ != states) && ...);
+    const auto state = state_.load(std::memory_order_relaxed);
+    return ((state != states) && ...);
   }
 
   void reset() override;
@@ -38,7 +46,8 @@ class StateManager : public utils::Parentable<ConnectionPrivate>, utils::IReseta
   void handle();
 
  private:
-  Connection::State state_;
+  // Written on the strand only, atomic so that Connection::state() can be read from any thread.
+  std::atomic<Connection::State> state_ = Connection::State::Closed;
 };
 
 }  // namespace detail
@@ -7,6 +7,8 @@ namespace protocol {
 namespace detail {
 
 std::optional<StreamSequenceNumber::value_type> StreamManager::find_readable() {
+  std::unique_lock lock(mutex_);
+
   for (const auto& [id, stream] : streams_) {
     if (stream.is_readable()) {
       return id;
@@ -17,6 +19,8 @@ std::optional<StreamSequenceNumber::value_type> StreamManager::find_readable() {
 }
 
 Stream& StreamManager::get(StreamSequenceNumber::value_type identifier) {
+  std::unique_lock lock(mutex_);
+
   return streams_.try_emplace(identifier, parent(), identifier).first->second;
 }
 
@@ -24,7 +28,14 @@ StreamPrivate& StreamManager::get_private(StreamSequenceNumber::value_type ident
   return *get(identifier).impl_;
 }
 
-void StreamManager::reset() { streams_.clear(); }
+void StreamManager::reset() {
+  std::unique_lock lock(mutex_);
+
+  // Reset in place, as references handed out by Connection::operator[] outlive an association.
+  for (auto& [id, stream] : streams_) {
+    stream.impl_->reset();
+  }
+}
 
 }  // namespace detail
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <unordered_map>
 
 #include "api/types/stream_sequence_number.hpp"
@@ -26,6 +27,9 @@ class StreamManager : public utils::Parentable<ConnectionPrivate>, utils::IReset
   void reset() override;
 
  private:
+  // Connection::operator[] may create streams from any thread, everything else runs on the
+  // strand. Only the lookup is guarded, the streams themselves are never moved.
+  mutable std::mutex mutex_;
   std::unordered_map<StreamSequenceNumber::value_type, Stream> streams_;
 };
 
@@ -26,8 +26,6 @@ void TimerManager::reset() {
 
 template <TimerManager::TimerId Id>
 void TimerManager::async_wait_timer_handler(ConnectionPrivate& parent) {
-  std::unique_lock lock(parent.mutex);
-
   const bool restart = parent.timer_manager.handler<Id>();
 
   parent.network_manager.write_pending_packets();
@@ -43,9 +41,11 @@ bool TimerManager::handler<TimerManager::TimerId::Init>() {
 
   ASSERT(parent().internal_data.type == Connection::Type::Client);
 
-  ASSERT(parent().internal_data.stored_init.has_value());
+  ASSERT(parent().internal_data.handshake != nullptr);
+  ASSERT(parent().internal_data.handshake->stored_init.has_value());
 
-  parent().out_control_queue.push(ChunkType::Initiation, *parent().internal_data.stored_init);
+  parent().out_control_queue.push(ChunkType::Initiation,
+                                  *parent().internal_data.handshake->stored_init);
 
   parent().rto_manager.backoff_rto();
 
@@ -114,6 +114,16 @@ bool TimerManager::handler<TimerManager::TimerId::Heartbeat>() {
   return true;
 }
 
+template <>
+bool TimerManager::handler<TimerManager::TimerId::Hibernate>() {
+  if (parent().hibernation_manager.is_idle()) {
+    parent().hibernation_manager.hibernate();
+    return false;
+  }
+
+  return true;
+}
+
 template <TimerManager::TimerId Id>
 void TimerManager::start_helper(std::chrono::milliseconds expiry_time) {
   auto& timer = timers_[timer_index<Id>()].emplace(parent().io_context, expiry_time);
@@ -160,6 +170,17 @@ void TimerManager::start<TimerManager::TimerId::Heartbeat>() {
                                    heartbeat_interval_);
 }
 
+template <>
+void TimerManager::start<TimerManager::TimerId::Hibernate>() {
+  auto interval = parent().hibernation_manager.interval();
+
+  if (!interval.has_value()) {
+    return;
+  }
+
+  start_helper<TimerId::Hibernate>(*interval);
+}
+
 void TimerManager::stop_all() {
   for (auto& timer_opt : timers_) {
     timer_opt.reset();
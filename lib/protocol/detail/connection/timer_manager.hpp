@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <asio/io_context.hpp>
 #include <asio/steady_timer.hpp>
 #include <optional>
 
@@ -15,10 +16,16 @@ class ConnectionPrivate;
 
 class TimerManager : public utils::Parentable<ConnectionPrivate>, utils::IResetable {
  public:
-  enum class TimerId { Init, Shutdown, Rtx, Ack, Heartbeat };
+  enum class TimerId { Init, Shutdown, Rtx, Ack, Heartbeat, Hibernate };
 
  private:
-  static constexpr size_t TIMER_COUNT = 5;
+  static constexpr size_t TIMER_COUNT = 6;
+
+  // Bound to the concrete io_context executor: the type-erased default executor of
+  // asio::steady_timer is several pointers wider, and there are TIMER_COUNT of them per connection.
+  using Timer = asio::basic_waitable_timer<std::chrono::steady_clock,
+                                           asio::wait_traits<std::chrono::steady_clock>,
+                                           asio::io_context::executor_type>;
 
  public:
   using Parentable::Parentable;
@@ -71,7 +78,7 @@ class TimerManager : public utils::Parentable<ConnectionPrivate>, utils::IReseta
  private:
   std::chrono::milliseconds ack_interval_;
   std::chrono::milliseconds heartbeat_interval_;
-  std::array<std::optional<asio::steady_timer>, TIMER_COUNT> timers_;
+  std::array<std::optional<Timer>, TIMER_COUNT> timers_;
 };
 
 template <>
@@ -89,6 +96,9 @@ void TimerManager::start<TimerManager::TimerId::Ack>();
 template <>
 void TimerManager::start<TimerManager::TimerId::Heartbeat>();
 
+template <>
+void TimerManager::start<TimerManager::TimerId::Hibernate>();
+
 }  // namespace detail
 
 }  // namespace protocol
@@ -0,0 +1,237 @@
+#include "datagram_pool.hpp"
+
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "utils/debug/assert.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+namespace {
+
+constexpr size_t BLOCKS_PER_SLAB = 64;
+constexpr size_t MAX_CACHED_BLOCKS = 128;
+
+}  // namespace
+
+struct DatagramPool::Shared {
+  std::mutex mutex;
+  Block* free_list = nullptr;
+
+  std::atomic<size_t> allocations = 0;
+  std::atomic<size_t> high_water_mark = 0;
+  std::atomic<size_t> in_use = 0;
+  std::atomic<size_t> misses = 0;
+  std::atomic<size_t> slabs = 0;
+};
+
+struct DatagramPool::Cache {
+  Block* head = nullptr;
+  size_t size = 0;
+
+  ~Cache() { flush(size); }
+
+  void flush(size_t count) {
+    if (count == 0) {
+      return;
+    }
+
+    Block* first = head;
+    Block* last = head;
+
+    for (size_t i = 1; i < count; ++i) {
+      last = last->next;
+    }
+
+    head = last->next;
+    size -= count;
+
+    auto& shared = DatagramPool::shared();
+
+    std::unique_lock lock(shared.mutex);
+
+    last->next = shared.free_list;
+    shared.free_list = first;
+  }
+
+  void push(Block* block) {
+    block->next = head;
+    head = block;
+    ++size;
+  }
+};
+
+DatagramPool::Statistics DatagramPool::statistics() {
+  auto& shared = DatagramPool::shared();
+
+  return {shared.allocations.load(std::memory_order_relaxed),
+          shared.high_water_mark.load(std::memory_order_relaxed),
+          shared.in_use.load(std::memory_order_relaxed),
+          shared.misses.load(std::memory_order_relaxed),
+          shared.slabs.load(std::memory_order_relaxed)};
+}
+
+DatagramPool::Block* DatagramPool::allocate(size_t size, bool exact) {
+  auto& shared = DatagramPool::shared();
+  auto& cache = DatagramPool::cache();
+
+  shared.allocations.fetch_add(1, std::memory_order_relaxed);
+
+  const size_t in_use = shared.in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+
+  for (size_t high_water_mark = shared.high_water_mark.load(std::memory_order_relaxed);
+       in_use > high_water_mark && !shared.high_water_mark.compare_exchange_weak(
+                                       high_water_mark, in_use, std::memory_order_relaxed);) {
+  }
+
+  // An exact block of a whole block's size is a pooled one, release() tells them apart by size.
+  if (size > BLOCK_SIZE || (exact && size < BLOCK_SIZE)) [[unlikely]] {
+    if (size > BLOCK_SIZE) {
+      shared.misses.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return new (::operator new(sizeof(Block) + size)) Block{{1}, static_cast<uint32_t>(size), {}};
+  }
+
+  if (cache.head == nullptr) [[unlikely]] {
+    std::unique_lock lock(shared.mutex);
+
+    while (shared.free_list != nullptr && cache.size < MAX_CACHED_BLOCKS / 2) {
+      auto* block = shared.free_list;
+
+      shared.free_list = block->next;
+
+      cache.push(block);
+    }
+  }
+
+  if (cache.head == nullptr) [[unlikely]] {
+    shared.misses.fetch_add(1, std::memory_order_relaxed);
+    shared.slabs.fetch_add(1, std::memory_order_relaxed);
+
+    // Slabs are never returned to the system, the pool only grows up to the high-water mark.
+    static constexpr size_t stride = sizeof(Block) + BLOCK_SIZE;
+
+    auto* slab = static_cast<uint8_t*>(::operator new(BLOCKS_PER_SLAB * stride));
+
+    for (size_t i = 0; i < BLOCKS_PER_SLAB; ++i) {
+      cache.push(new (slab + i * stride) Block{{0}, BLOCK_SIZE, {}});
+    }
+  }
+
+  auto* block = cache.head;
+
+  cache.head = block->next;
+  --cache.size;
+
+  block->references.store(1, std::memory_order_relaxed);
+
+  return block;
+}
+
+void DatagramPool::release(Block* block) {
+  if (block->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+
+  shared().in_use.fetch_sub(1, std::memory_order_relaxed);
+
+  if (block->capacity != BLOCK_SIZE) [[unlikely]] {
+    block->~Block();
+    ::operator delete(block);
+    return;
+  }
+
+  auto& cache = DatagramPool::cache();
+
+  cache.push(block);
+
+  if (cache.size > MAX_CACHED_BLOCKS) {
+    cache.flush(MAX_CACHED_BLOCKS / 2);
+  }
+}
+
+DatagramPool::Cache& DatagramPool::cache() {
+  // Touches the shared state first so that it outlives every thread's cache.
+  shared();
+
+  thread_local Cache cache;
+
+  return cache;
+}
+
+DatagramPool::Shared& DatagramPool::shared() {
+  static Shared shared;
+
+  return shared;
+}
+
+DatagramSlice::DatagramSlice(DatagramPool::Block* block, uint8_t* data, size_t size)
+    : block_(block), data_(data), size_(size) {}
+
+DatagramSlice::DatagramSlice(const DatagramSlice& other)
+    : block_(other.block_), data_(other.data_), size_(other.size_) {
+  if (block_ != nullptr) {
+    block_->references.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+DatagramSlice::DatagramSlice(DatagramSlice&& other) noexcept
+    : block_(std::exchange(other.block_, nullptr)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+DatagramSlice::~DatagramSlice() {
+  if (block_ != nullptr) {
+    DatagramPool::release(block_);
+  }
+}
+
+DatagramSlice& DatagramSlice::operator=(const DatagramSlice& other) {
+  return *this = DatagramSlice(other);
+}
+
+DatagramSlice& DatagramSlice::operator=(DatagramSlice&& other) noexcept {
+  std::swap(block_, other.block_);
+  std::swap(data_, other.data_);
+  std::swap(size_, other.size_);
+  return *this;
+}
+
+DatagramSlice DatagramSlice::allocate(size_t size) {
+  auto* block = DatagramPool::allocate(size);
+
+  return DatagramSlice(block, block->data(), size);
+}
+
+DatagramSlice DatagramSlice::copy(std::span<const uint8_t> data) {
+  auto* block = DatagramPool::allocate(data.size(), true);
+
+  std::memcpy(block->data(), data.data(), data.size());
+
+  return DatagramSlice(block, block->data(), data.size());
+}
+
+void DatagramSlice::shrink(size_t size) {
+  ASSERT(size <= size_);
+
+  size_ = size;
+}
+
+DatagramSlice DatagramSlice::slice(std::span<const uint8_t> part) const {
+  ASSERT(part.data() >= data_ && part.data() + part.size() <= data_ + size_);
+
+  if (block_ != nullptr) {
+    block_->references.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return DatagramSlice(block_, data_ + (part.data() - data_), part.size());
+}
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace protocol {
+
+namespace detail {
+
+class DatagramSlice;
+
+// Process wide pool of datagram sized blocks. Blocks are carved out of slabs and recycled through
+// a per-thread cache backed by a shared free list, so a block is normally reused by the thread
+// (and thus the memory node) that touched it last. Datagrams larger than a block are served by
+// one-off allocations and counted as misses.
+class DatagramPool {
+ public:
+  static constexpr size_t BLOCK_SIZE = 2048;
+
+  struct Statistics {
+    size_t allocations;
+    size_t high_water_mark;  // most blocks in use at once
+    size_t in_use;
+    size_t misses;  // allocations that needed a new slab or an oversized block
+    size_t slabs;
+  };
+
+ public:
+  [[nodiscard]] static Statistics statistics();
+
+ private:
+  struct Block {
+    std::atomic<uint32_t> references;
+    uint32_t capacity;
+    Block* next;
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+  };
+
+ private:
+  struct Cache;
+  struct Shared;
+
+ private:
+  // An exact block is allocated on its own with no room to spare, for data that is held on to.
+  static Block* allocate(size_t size, bool exact = false);
+
+  static void release(Block* block);
+
+  static Cache& cache();
+
+  static Shared& shared();
+
+ private:
+  friend class DatagramSlice;
+};
+
+// Reference counted view into a pooled block. Copies share the block, sub-slices let parsed parts
+// of a datagram (e.g. a received fragment) outlive the datagram without being copied out.
+class DatagramSlice {
+ public:
+  DatagramSlice() = default;
+
+  DatagramSlice(const DatagramSlice& other);
+  DatagramSlice(DatagramSlice&& other) noexcept;
+
+  ~DatagramSlice();
+
+  DatagramSlice& operator=(const DatagramSlice& other);
+  DatagramSlice& operator=(DatagramSlice&& other) noexcept;
+
+  // Slice of the given size with unspecified contents.
+  static DatagramSlice allocate(size_t size);
+
+  // Copy in a block sized to fit, so data held on to for long does not pin a whole pooled block.
+  // Data filling a whole block is copied into a pooled one.
+  static DatagramSlice copy(std::span<const uint8_t> data);
+
+  [[nodiscard]] uint8_t* data() const { return data_; }
+
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  [[nodiscard]] size_t size() const { return size_; }
+
+  // Shrinks the slice, e.g. to the number of bytes actually received.
+  void shrink(size_t size);
+
+  // Shares the block for a part of this slice.
+  [[nodiscard]] DatagramSlice slice(std::span<const uint8_t> part) const;
+
+  operator std::span<uint8_t>() const { return {data_, size_}; }
+
+ private:
+  DatagramSlice(DatagramPool::Block* block, uint8_t* data, size_t size);
+
+ private:
+  DatagramPool::Block* block_ = nullptr;
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -0,0 +1,135 @@
+#include "impairment_queue.hpp"
+
+#include <asio/bind_executor.hpp>
+
+#include "serialization/buffer_pool.hpp"
+#include "utils/debug/assert.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+ImpairmentQueue::ImpairmentQueue(asio::io_context::strand strand,
+                                 const Connection::NetworkImpairment& config, Sender sender)
+    : config_(config),
+      sender_(std::move(sender)),
+      strand_(std::move(strand)),
+      timer_(strand_.context()),
+      random_(config.seed),
+      bad_state_(false),
+      in_flight_bytes_(0) {
+  ASSERT(sender_ != nullptr);
+}
+
+void ImpairmentQueue::push(std::vector<uint8_t>&& datagram) {
+  ASSERT(strand_.running_in_this_thread());
+
+  if (lose()) {
+    serialization::BufferPool::release(std::move(datagram));
+    return;
+  }
+
+  if (chance(config_.duplication)) {
+    schedule(std::vector<uint8_t>(datagram));
+  }
+
+  schedule(std::move(datagram));
+}
+
+bool ImpairmentQueue::chance(double probability) {
+  if (probability <= 0.0) [[likely]] {
+    return false;
+  }
+
+  return std::uniform_real_distribution<double>()(random_) < probability;
+}
+
+bool ImpairmentQueue::lose() {
+  if (!config_.gilbert_elliott.has_value()) [[likely]] {
+    return chance(config_.loss);
+  }
+
+  const auto& model = *config_.gilbert_elliott;
+
+  if (chance(bad_state_ ? model.bad_to_good : model.good_to_bad)) {
+    bad_state_ = !bad_state_;
+  }
+
+  return chance(bad_state_ ? model.bad_loss : model.good_loss);
+}
+
+void ImpairmentQueue::schedule(std::vector<uint8_t>&& datagram) {
+  if (config_.queue_limit.has_value() &&
+      in_flight_bytes_ + datagram.size() > *config_.queue_limit) [[unlikely]] {
+    serialization::BufferPool::release(std::move(datagram));
+    return;
+  }
+
+  const auto now = Clock::now();
+
+  // Serialization onto the link, datagrams queue behind each other.
+  auto departure = now;
+
+  if (config_.bandwidth.has_value()) {
+    const auto transmission = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(datagram.size()) / *config_.bandwidth));
+
+    departure = std::max(now, link_free_) + transmission;
+    link_free_ = departure;
+  }
+
+  auto arrival = departure;
+
+  if (!chance(config_.reordering)) [[likely]] {
+    arrival += config_.delay;
+
+    if (config_.jitter.count() > 0) {
+      arrival += std::chrono::microseconds(std::uniform_int_distribution<int64_t>(
+          0, config_.jitter.count())(random_));
+    }
+  }
+
+  in_flight_bytes_ += datagram.size();
+
+  const bool earliest = in_flight_.empty() || arrival < in_flight_.cbegin()->first;
+
+  in_flight_.emplace(arrival, std::move(datagram));
+
+  if (earliest) {
+    start_timer();
+  }
+}
+
+void ImpairmentQueue::start_timer() {
+  timer_.expires_at(in_flight_.cbegin()->first);
+  timer_.async_wait(asio::bind_executor(
+      strand_, [weak_this = weak_from_this()](const asio::error_code& error) {
+        if (error) {
+          return;
+        }
+
+        if (auto shared_this = weak_this.lock()) [[likely]] {
+          shared_this->async_wait_timer_handler();
+        }
+      }));
+}
+
+void ImpairmentQueue::async_wait_timer_handler() {
+  const auto now = Clock::now();
+
+  while (!in_flight_.empty() && in_flight_.cbegin()->first <= now) {
+    auto node = in_flight_.extract(in_flight_.cbegin());
+
+    in_flight_bytes_ -= node.mapped().size();
+
+    sender_(std::move(node.mapped()));
+  }
+
+  if (!in_flight_.empty()) {
+    start_timer();
+  }
+}
+
+}  // namespace detail
+
+}  // namespace protocol
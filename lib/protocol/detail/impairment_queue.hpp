@@ -0,0 +1,64 @@
+#pragma once
+
+#include <asio/io_context_strand.hpp>
+#include <asio/steady_timer.hpp>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "connection.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+// Simulated link between the network manager and the socket. Datagrams are dropped, duplicated,
+// serialized at the configured bandwidth, delayed and possibly reordered before being handed to
+// the sender, all on the connection strand. Decisions only depend on the seed and the order of
+// the datagrams, so a run can be reproduced.
+class ImpairmentQueue : public std::enable_shared_from_this<ImpairmentQueue> {
+ public:
+  using Sender = std::function<void(std::vector<uint8_t>&&)>;
+
+ public:
+  ImpairmentQueue(asio::io_context::strand strand, const Connection::NetworkImpairment& config,
+                  Sender sender);
+
+  void push(std::vector<uint8_t>&& datagram);
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+ private:
+  [[nodiscard]] bool chance(double probability);
+
+  [[nodiscard]] bool lose();
+
+  void schedule(std::vector<uint8_t>&& datagram);
+
+  void start_timer();
+
+ private:
+  void async_wait_timer_handler();
+
+ private:
+  const Connection::NetworkImpairment config_;
+  const Sender sender_;
+
+  asio::io_context::strand strand_;
+  asio::steady_timer timer_;
+
+  std::mt19937_64 random_;
+  bool bad_state_;
+
+  std::multimap<Clock::time_point, std::vector<uint8_t>> in_flight_;
+  size_t in_flight_bytes_;
+  Clock::time_point link_free_;
+};
+
+}  // namespace detail
+
+}  // namespace protocol
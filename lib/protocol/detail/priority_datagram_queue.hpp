@@ -0,0 +1,109 @@
+#pragma once
+
+#include <asio/bind_executor.hpp>
+#include <asio/generic/datagram_protocol.hpp>
+#include <asio/io_context_strand.hpp>
+#include <deque>
+#include <memory>
+#include <optional>
+
+#include "serialization/buffer_pool.hpp"
+#include "utils/debug/assert.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+// Bounded queue for control datagrams that must go out ahead of data and must never block the
+// caller (ABORT, SHUTDOWN COMPLETE). Datagrams are sent with non-blocking sends right away, the
+// remainder waits for the socket to become writable. Pending waits keep the queue and the socket
+// alive, so the datagrams are still flushed after the connection itself is gone.
+class PriorityDatagramQueue : public std::enable_shared_from_this<PriorityDatagramQueue> {
+ public:
+  using socket_type = asio::generic::datagram_protocol::socket;
+  using endpoint_type = asio::generic::datagram_protocol::endpoint;
+
+  static constexpr size_t MAX_DATAGRAMS = 16;
+
+ private:
+  struct Datagram {
+    std::optional<endpoint_type> endpoint;
+    std::vector<uint8_t> data;
+  };
+
+ public:
+  PriorityDatagramQueue(asio::io_context::strand strand, std::shared_ptr<socket_type> socket)
+      : strand_(std::move(strand)), socket_(std::move(socket)), waiting_(false) {
+    ASSERT(socket_ != nullptr);
+
+    asio::error_code ignored_error;
+
+    socket_->non_blocking(true, ignored_error);
+  }
+
+  // Returns false if the queue is full and the datagram was dropped.
+  bool push(std::optional<endpoint_type> endpoint, std::vector<uint8_t> data) {
+    ASSERT(strand_.running_in_this_thread());
+
+    if (datagrams_.size() == MAX_DATAGRAMS) [[unlikely]] {
+      return false;
+    }
+
+    datagrams_.push_back({std::move(endpoint), std::move(data)});
+
+    if (!waiting_) {
+      flush();
+    }
+
+    return true;
+  }
+
+ private:
+  void flush() {
+    while (!datagrams_.empty()) {
+      auto& datagram = datagrams_.front();
+
+      asio::error_code error;
+
+      if (datagram.endpoint.has_value()) {
+        socket_->send_to(asio::buffer(datagram.data), *datagram.endpoint, 0, error);
+      } else {
+        socket_->send(asio::buffer(datagram.data), 0, error);
+      }
+
+      if (error == asio::error::would_block || error == asio::error::try_again) {
+        waiting_ = true;
+
+        auto handler = [self = shared_from_this()](const asio::error_code& error) {
+          self->waiting_ = false;
+
+          if (error) [[unlikely]] {
+            self->datagrams_.clear();
+            return;
+          }
+
+          self->flush();
+        };
+
+        socket_->async_wait(asio::socket_base::wait_write,
+                            asio::bind_executor(strand_, std::move(handler)));
+        return;
+      }
+
+      // Sent or failed for good, either way there is nothing to retry.
+      serialization::BufferPool::release(std::move(datagram.data));
+
+      datagrams_.pop_front();
+    }
+  }
+
+ private:
+  asio::io_context::strand strand_;
+  std::shared_ptr<socket_type> socket_;
+  std::deque<Datagram> datagrams_;
+  bool waiting_;
+};
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -0,0 +1,102 @@
+#include "handshake_rate_limiter.hpp"
+
+#include <algorithm>
+#include <random>
+
+#include "utils/hash_range.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+namespace {
+
+template <size_t N>
+void apply_prefix(std::array<uint8_t, N>& bytes, uint8_t prefix_length) {
+  const size_t bits = std::min<size_t>(prefix_length, N * 8);
+
+  for (size_t i = 0; i < N; ++i) {
+    if (i * 8 >= bits) {
+      bytes[i] = 0;
+    } else if (i * 8 + 8 > bits) {
+      bytes[i] &= static_cast<uint8_t>(0xFF << (8 - (bits - i * 8)));
+    }
+  }
+}
+
+}  // namespace
+
+HandshakeRateLimiter::HandshakeRateLimiter(const Server::HandshakeRateLimit& config)
+    : config_(config), epoch_(std::chrono::steady_clock::now()) {
+  std::random_device random_device;
+
+  for (auto& seed : seeds_) {
+    seed = (static_cast<size_t>(random_device()) << 32) ^ random_device();
+  }
+
+  for (auto& row : buckets_) {
+    row.fill(Bucket{static_cast<float>(config_.burst), 0});
+  }
+}
+
+bool HandshakeRateLimiter::try_acquire(const asio::ip::address& address) {
+  // Wraps after ~49 days, which only matters for buckets untouched for that long.
+  const auto now_ms = static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                            epoch_)
+          .count());
+
+  std::unique_lock lock(mutex_);
+
+  const auto rate_per_ms = static_cast<float>(config_.rate / 1000.0);
+  const auto burst = static_cast<float>(config_.burst);
+
+  std::array<Bucket*, ROWS> buckets;
+
+  float estimate = 0.0f;
+
+  for (size_t row = 0; row < ROWS; ++row) {
+    auto& bucket = buckets_[row][bucket_index(row, address)];
+
+    const uint32_t elapsed_ms = now_ms - bucket.last_refill_ms;
+
+    bucket.tokens = std::min(burst, bucket.tokens + static_cast<float>(elapsed_ms) * rate_per_ms);
+    bucket.last_refill_ms = now_ms;
+
+    estimate = std::max(estimate, bucket.tokens);
+
+    buckets[row] = &bucket;
+  }
+
+  if (estimate < 1.0f) {
+    return false;
+  }
+
+  for (auto* bucket : buckets) {
+    bucket->tokens = std::max(bucket->tokens - 1.0f, 0.0f);
+  }
+
+  return true;
+}
+
+size_t HandshakeRateLimiter::bucket_index(size_t row, const asio::ip::address& address) const {
+  size_t seed = seeds_[row];
+
+  if (address.is_v4() || (address.is_v6() && address.to_v6().is_v4_mapped())) {
+    auto bytes = address.is_v4()
+                     ? address.to_v4().to_bytes()
+                     : asio::ip::make_address_v4(asio::ip::v4_mapped, address.to_v6()).to_bytes();
+    apply_prefix(bytes, config_.ipv4_prefix_length);
+    utils::hash_range(seed, bytes.cbegin(), bytes.cend());
+  } else {
+    auto bytes = address.to_v6().to_bytes();
+    apply_prefix(bytes, config_.ipv6_prefix_length);
+    utils::hash_range(seed, bytes.cbegin(), bytes.cend());
+  }
+
+  return seed % ROW_SIZE;
+}
+
+}  // namespace detail
+
+}  // namespace protocol
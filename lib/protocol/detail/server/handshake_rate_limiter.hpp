@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <asio/ip/address.hpp>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+#include "server.hpp"
+
+namespace protocol {
+
+namespace detail {
+
+// Token buckets keyed by source address prefix. Keys are not stored: every prefix maps to one
+// bucket in each of a few independently seeded rows and is charged in all of them, as in a
+// count-min sketch. The fullest of its buckets is the one shared with the fewest other prefixes,
+// so it is the estimate: a handshake is admitted if that bucket holds a token. A prefix is thus
+// only limited wrongly when it collides with a flooding one in every row, and memory does not
+// grow with the number of sources.
+class HandshakeRateLimiter {
+ private:
+  static constexpr size_t ROWS = 2;
+  static constexpr size_t ROW_SIZE = 4096;
+
+  struct Bucket {
+    float tokens;
+    uint32_t last_refill_ms;
+  };
+
+ public:
+  explicit HandshakeRateLimiter(const Server::HandshakeRateLimit& config);
+
+  bool try_acquire(const asio::ip::address& address);
+
+ private:
+  [[nodiscard]] size_t bucket_index(size_t row, const asio::ip::address& address) const;
+
+ private:
+  std::mutex mutex_;
+  const Server::HandshakeRateLimit config_;
+  std::chrono::steady_clock::time_point epoch_;
+  std::array<size_t, ROWS> seeds_;
+  std::array<std::array<Bucket, ROW_SIZE>, ROWS> buckets_;
+};
+
+}  // namespace detail
+
+}  // namespace protocol
@@ -1,5 +1,4 @@
-#include <asio/bind_executor.hpp>
-
+#include "connection_p.hpp"
 #include "crypto/helpers.hpp"
 #include "crypto/sidhp434_compressed.hpp"
 #include "detail/async_recursive_read_datagram.hpp"
@@ -18,6 +17,10 @@ using namespace detail;
 namespace {
 
 constexpr std::chrono::seconds CLOSING_INTERVAL{10};
+constexpr std::chrono::seconds TOMBSTONE_BUCKET_INTERVAL{1};
+
+// 2^64 divided by the golden ratio, spreads consecutive connection ids over the seed space.
+constexpr uint64_t SEED_INCREMENT = 0x9E3779B97F4A7C15;
 
 [[maybe_unused]] void bind_to_loopback_v4(asio::ip::udp::socket& socket) {
   socket.close();
@@ -74,6 +77,43 @@ create_socket_pair(asio::io_context& io_context) {
   return std::make_pair(nullptr, nullptr);
 }
 
+// Every connection gets an impairment sequence of its own, still reproducible from the seed.
+[[nodiscard]] uint64_t connection_seed(uint64_t seed, ConnectionID connection_id) {
+  return seed + (uint64_t{connection_id} + 1) * SEED_INCREMENT;
+}
+
+// Counters only ever grow over the lifetime of a connection, so they are kept once it closes.
+void accumulate_counters(Connection::Statistics& total, const Connection::Statistics& statistics) {
+  total.abandoned_chunks += statistics.abandoned_chunks;
+  total.bytes_received += statistics.bytes_received;
+  total.bytes_sent += statistics.bytes_sent;
+  total.decrypt_failures += statistics.decrypt_failures;
+  total.fast_recovery_entries += statistics.fast_recovery_entries;
+  total.fast_retransmissions += statistics.fast_retransmissions;
+  total.gap_ack_blocks += statistics.gap_ack_blocks;
+  total.packets_received += statistics.packets_received;
+  total.packets_sent += statistics.packets_sent;
+  total.replay_rejections += statistics.replay_rejections;
+  total.retransmissions += statistics.retransmissions;
+  total.timeouts += statistics.timeouts;
+}
+
+// Gauges describe the live connections only. first is set for the first one accumulated.
+void accumulate_gauges(Connection::Statistics& total, const Connection::Statistics& statistics,
+                       bool first) {
+  total.bytes_in_flight += statistics.bytes_in_flight;
+  total.in_flight_chunks += statistics.in_flight_chunks;
+  total.out_of_order_chunks += statistics.out_of_order_chunks;
+  total.pending_chunks += statistics.pending_chunks;
+
+  total.cwnd = first ? statistics.cwnd : std::min(total.cwnd, statistics.cwnd);
+  total.handshake_time = std::max(total.handshake_time, statistics.handshake_time);
+  total.rto = std::max(total.rto, statistics.rto);
+  total.rttvar = std::max(total.rttvar, statistics.rttvar);
+  total.srtt = std::max(total.srtt, statistics.srtt);
+  total.ssthresh = first ? statistics.ssthresh : std::min(total.ssthresh, statistics.ssthresh);
+}
+
 }  // namespace
 
 Server::Server(asio::io_context& io_context) : impl_(new ServerPrivate(io_context)) {}
@@ -91,6 +131,8 @@ void Server::close() {
 
   impl_->socket.reset();
 
+  impl_->handshakes_in_progress = 0;
+
   {
     std::unique_lock lock(impl_->connections, std::try_to_lock);
 
@@ -105,6 +147,13 @@ void Server::close() {
 
     impl_->pending_connections.clear();
   }
+  {
+    std::unique_lock lock(impl_->tombstones);
+
+    impl_->tombstones.connection_ids.reset();
+    impl_->tombstones.buckets.clear();
+    impl_->tombstones.sweep_timer.reset();
+  }
 }
 
 bool Server::has_pending_connections() const {
@@ -195,6 +244,12 @@ void Server::open(Configuration&& config) {
     throw std::runtime_error("is already open");
   }
 
+  // A bucket that cannot hold a whole token would turn every handshake away.
+  if (config.handshake_rate_limit.has_value() && !(config.handshake_rate_limit->burst >= 1.0))
+      [[unlikely]] {
+    throw std::runtime_error("handshake burst is less than 1");
+  }
+
   asio::ip::udp::socket socket(impl_->io_context);
 
   socket.close();
@@ -208,6 +263,27 @@ void Server::open(Configuration&& config) {
   std::unique_lock lock(impl_->mutex);
 
   impl_->backlog = config.backlog;
+  impl_->connection_io_contexts = std::move(config.connection_io_contexts);
+
+  if (impl_->connection_io_contexts.empty()) {
+    impl_->connection_io_contexts.emplace_back(impl_->io_context);
+  }
+
+  {
+    std::unique_lock lock(impl_->closed_connections);
+
+    impl_->closed_connections.statistics = {};
+  }
+
+  impl_->hibernation_interval = config.hibernation_interval;
+  impl_->max_concurrent_handshakes = config.max_concurrent_handshakes;
+  impl_->network_impairment = config.network_impairment;
+
+  if (config.handshake_rate_limit.has_value()) {
+    impl_->handshake_rate_limiter.emplace(*config.handshake_rate_limit);
+  } else {
+    impl_->handshake_rate_limiter.reset();
+  }
 
   crypto::Helpers::memzero(impl_->secret_key.data(), impl_->secret_key.size());
 
@@ -224,16 +300,55 @@ void Server::open(Configuration&& config) {
       });
 }
 
+Server::Statistics Server::statistics() const {
+  Statistics result{};
+
+  constexpr auto relaxed = std::memory_order_relaxed;
+
+  result.accepted_handshakes = impl_->statistics.accepted_handshakes.load(relaxed);
+  result.dropped_handshakes = impl_->statistics.dropped_handshakes.load(relaxed);
+  result.limited_handshakes = impl_->statistics.limited_handshakes.load(relaxed);
+
+  std::shared_lock lock(impl_->connections);
+
+  // Held throughout, so a connection closing meanwhile is counted either as live or as closed.
+  std::unique_lock closed_lock(impl_->closed_connections);
+
+  accumulate_counters(result.transport, impl_->closed_connections.statistics);
+
+  for (auto& [connection_id, connection_details] : impl_->connections) {
+    std::unique_lock lock(connection_details);
+
+    if (connection_details.statistics == nullptr ||
+        connection_details.state == ConnectionDetails::State::Closing) [[unlikely]] {
+      continue;
+    }
+
+    const auto statistics = connection_details.statistics->snapshot();
+
+    accumulate_counters(result.transport, statistics);
+    accumulate_gauges(result.transport, statistics, result.connections == 0);
+
+    ++result.connections;
+  }
+
+  return result;
+}
+
 std::shared_ptr<Server::NewConnectionEvent> Server::new_connection() const {
   return impl_->new_connection_event;
 }
 
 ServerPrivate::ServerPrivate(asio::io_context& io_context)
-    : io_context(io_context), new_connection_event(Server::NewConnectionEvent::create()) {}
+    : io_context(io_context),
+      handshakes_in_progress(0),
+      next_connection_io_context(0),
+      statistics{},
+      new_connection_event(Server::NewConnectionEvent::create()) {}
 
 ServerPrivate::~ServerPrivate() = default;
 
-void ServerPrivate::create_new_connection(std::vector<uint8_t>&& data,
+void ServerPrivate::create_new_connection(DatagramSlice&& data,
                                           asio::ip::udp::endpoint&& endpoint) {
   Packet packet(data);
 
@@ -255,23 +370,52 @@ void ServerPrivate::create_new_connection(std::vector<uint8_t>&& data,
     return;
   }
 
+  // Everything below allocates sockets and a connection, so floods are turned away first.
+  if (handshake_rate_limiter.has_value() &&
+      !handshake_rate_limiter->try_acquire(endpoint.address())) [[unlikely]] {
+    statistics.limited_handshakes.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
   if (backlog != 0) {
     std::unique_lock lock(pending_connections);
 
     if (pending_connections.size() == backlog) {
+      statistics.dropped_handshakes.fetch_add(1, std::memory_order_relaxed);
       return;
     }
   }
 
-  auto [rx_socket, rx_socket_server] = create_socket_pair(io_context);
+  if (handshakes_in_progress.fetch_add(1, std::memory_order_relaxed) >=
+      max_concurrent_handshakes.value_or(std::numeric_limits<size_t>::max())) [[unlikely]] {
+    handshakes_in_progress.fetch_sub(1, std::memory_order_relaxed);
+    statistics.dropped_handshakes.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  auto drop = [this]() {
+    handshakes_in_progress.fetch_sub(1, std::memory_order_relaxed);
+    statistics.dropped_handshakes.fetch_add(1, std::memory_order_relaxed);
+  };
+
+  // Everything owned by the connection lives on its io_context, including the server side of its
+  // socket pairs, so its handlers never migrate to another one.
+  auto& connection_io_context =
+      connection_io_contexts[next_connection_io_context.fetch_add(1, std::memory_order_relaxed) %
+                             connection_io_contexts.size()]
+          .get();
+
+  auto [rx_socket, rx_socket_server] = create_socket_pair(connection_io_context);
 
   if (rx_socket == nullptr || rx_socket_server == nullptr) [[unlikely]] {
+    drop();
     return;
   }
 
-  auto [tx_socket, tx_socket_server] = create_socket_pair(io_context);
+  auto [tx_socket, tx_socket_server] = create_socket_pair(connection_io_context);
 
   if (tx_socket == nullptr || tx_socket_server == nullptr) [[unlikely]] {
+    drop();
     return;
   }
 
@@ -279,15 +423,30 @@ void ServerPrivate::create_new_connection(std::vector<uint8_t>&& data,
 
   {
     std::unique_lock lock(connections);
+    std::unique_lock tombstones_lock(tombstones);
+
+    bool allocated = false;
+
+    for (size_t i = 0; i <= std::numeric_limits<ConnectionID>::max(); ++i) {
+      auto candidate = connections.next_id++;
+
+      if (tombstones.connection_ids.test(candidate)) {
+        continue;
+      }
 
-    while (true) {
-      auto [iterator, success] = connections.try_emplace(connections.next_id++, io_context);
+      auto [iterator, success] = connections.try_emplace(candidate, connection_io_context);
 
       if (success) [[likely]] {
         connection_id = iterator->first;
+        allocated = true;
         break;
       }
     }
+
+    if (!allocated) [[unlikely]] {
+      drop();
+      return;
+    }
   }
   {
     std::shared_lock lock(connections);
@@ -301,7 +460,9 @@ void ServerPrivate::create_new_connection(std::vector<uint8_t>&& data,
     {
       std::unique_lock lock(connection_details);
 
-      connection_details.connection = std::make_shared<Connection>(io_context);
+      connection_details.connection = std::make_shared<Connection>(connection_io_context);
+      connection_details.statistics = std::shared_ptr<const ConnectionStatistics>(
+          connection_details.connection->impl_, &connection_details.connection->impl_->statistics);
       connection_details.state_changed_subscription =
           connection_details.connection->state_changed()->subscribe(
               [weak_self = weak_from_this(), connection_id](auto&&... args) {
@@ -311,17 +472,21 @@ void ServerPrivate::create_new_connection(std::vector<uint8_t>&& data,
                 }
               });
 
-      async_recursive_read_datagram(connection_details.strand, tx_socket_server,
-                                    [weak_self = weak_from_this(), connection_id](auto&&... args) {
-                                      if (auto self = weak_self.lock()) [[likely]] {
-                                        self->async_receive_tx_socket_server_handler(
-                                            connection_id, std::forward<decltype(args)>(args)...);
-                                      }
-                                    });
+      connection_details.relay_target = std::make_shared<RelayTarget>();
+      connection_details.relay_target->endpoint = std::move(endpoint);
+
+      async_recursive_read_datagram(
+          connection_details.strand, tx_socket_server,
+          [weak_self = weak_from_this(), connection_id,
+           relay_target = connection_details.relay_target](auto&&... args) {
+            if (auto self = weak_self.lock()) [[likely]] {
+              self->async_receive_tx_socket_server_handler(
+                  connection_id, *relay_target, std::forward<decltype(args)>(args)...);
+            }
+          });
 
       connection_details.rx_socket_server = rx_socket_server;
       connection_details.tx_socket_server = tx_socket_server;
-      connection_details.source_endpoint = std::move(endpoint);
 
       connection_details.state = ConnectionDetails::State::Connecting;
 
@@ -329,17 +494,91 @@ void ServerPrivate::create_new_connection(std::vector<uint8_t>&& data,
 
       config.rx_socket = std::move(rx_socket);
       config.tx_socket = std::move(tx_socket);
+      config.hibernation_interval = hibernation_interval;
+      config.network_impairment = network_impairment;
       config.connection_id = connection_id;
       config.secret_key = secret_key;
 
+      if (config.network_impairment.has_value()) {
+        config.network_impairment->seed =
+            connection_seed(config.network_impairment->seed, connection_id);
+      }
+
       connection_details.connection->associate(std::move(config));
     }
   }
 
+  statistics.accepted_handshakes.fetch_add(1, std::memory_order_relaxed);
+
   async_send_datagram(*rx_socket_server, std::nullopt, std::move(data));
 }
 
-void ServerPrivate::redirect_encrypted_packet(std::vector<uint8_t>&& data,
+void ServerPrivate::bury_connection(ConnectionID connection_id) {
+  std::unique_lock lock(tombstones);
+
+  const auto deadline = std::chrono::steady_clock::now() + CLOSING_INTERVAL;
+  const auto expiry = deadline + (TOMBSTONE_BUCKET_INTERVAL -
+                                  deadline.time_since_epoch() % TOMBSTONE_BUCKET_INTERVAL);
+
+  tombstones.connection_ids.set(connection_id);
+
+  if (tombstones.buckets.empty() || tombstones.buckets.back().expiry != expiry) {
+    tombstones.buckets.push_back({expiry, {}});
+  }
+
+  tombstones.buckets.back().connection_ids.push_back(connection_id);
+
+  if (!tombstones.sweep_timer.has_value()) {
+    start_sweep_timer(tombstones.buckets.front().expiry);
+  }
+}
+
+void ServerPrivate::erase_connection(ConnectionID connection_id) {
+  std::shared_lock lock(mutex, std::try_to_lock);
+
+  if (!lock.owns_lock()) {
+    return;
+  }
+
+  // Destroyed once the locks are released.
+  std::shared_ptr<Connection> connection;
+  std::shared_ptr<const ConnectionStatistics> statistics;
+
+  {
+    std::unique_lock lock(connections);
+
+    auto connections_iterator = connections.find(connection_id);
+
+    if (connections_iterator == connections.end()) [[unlikely]] {
+      return;
+    }
+
+    auto& connection_details = connections_iterator->second;
+
+    {
+      std::unique_lock lock(connection_details, std::try_to_lock);
+
+      ASSERT(lock.owns_lock());
+
+      ASSERT(connection_details.state == ConnectionDetails::State::Closing);
+
+      connection = std::move(connection_details.connection);
+      statistics = std::move(connection_details.statistics);
+
+      // The last packets of the connection, e.g. its ABORT, may still wait in the tx socket pair.
+      // Its sockets are kept until the relay has drained it, which erases the details again.
+      asio::error_code error;
+
+      if (connection_details.tx_socket_server->available(error) != 0 && !error) {
+        return;
+      }
+    }
+
+    connections.erase(connections_iterator);
+  }
+}
+
+void ServerPrivate::redirect_encrypted_packet(DatagramSlice&& data,
                                               asio::ip::udp::endpoint&& endpoint) {
   Packet packet(data);
 
@@ -362,26 +601,27 @@ void ServerPrivate::redirect_encrypted_packet(std::vector<uint8_t>&& data,
 
     async_send_datagram(*connection_details.rx_socket_server, std::nullopt, std::move(data));
 
-    connection_details.source_endpoint = std::move(endpoint);
+    {
+      std::unique_lock lock(*connection_details.relay_target);
+
+      connection_details.relay_target->endpoint = std::move(endpoint);
+    }
   }
 }
 
-void ServerPrivate::start_closing_timer(ConnectionDetails& connection_details,
-                                        ConnectionID connection_id) {
-  connection_details.closing_timer.emplace(io_context, CLOSING_INTERVAL);
-  connection_details.closing_timer->async_wait(asio::bind_executor(
-      connection_details.strand,
-      [weak_self = weak_from_this(), connection_id](const asio::error_code& error) {
-        if (error) [[unlikely]] {
-          return;
-        }
-        if (auto self = weak_self.lock()) [[likely]] {
-          self->async_wait_closing_timer_handler(connection_id);
-        }
-      }));
+void ServerPrivate::start_sweep_timer(std::chrono::steady_clock::time_point expiry) {
+  tombstones.sweep_timer.emplace(io_context, expiry);
+  tombstones.sweep_timer->async_wait([weak_self = weak_from_this()](const asio::error_code& error) {
+    if (error) [[unlikely]] {
+      return;
+    }
+    if (auto self = weak_self.lock()) [[likely]] {
+      self->async_wait_sweep_timer_handler();
+    }
+  });
 }
 
-void ServerPrivate::async_receive_socket_handler(std::vector<uint8_t> data,
+void ServerPrivate::async_receive_socket_handler(DatagramSlice data,
                                                  asio::ip::udp::endpoint endpoint) {
   std::shared_lock lock(mutex, std::try_to_lock);
 
@@ -403,37 +643,38 @@ void ServerPrivate::async_receive_socket_handler(std::vector<uint8_t> data,
 }
 
 void ServerPrivate::async_receive_tx_socket_server_handler(
-    ConnectionID connection_id, std::vector<uint8_t> data,
+    ConnectionID connection_id, RelayTarget& relay_target, DatagramSlice data,
     [[maybe_unused]] const asio::generic::datagram_protocol::endpoint& endpoint) {
   [[maybe_unused]] Packet packet(data);
 
   ASSERT(packet.validate());
   ASSERT(packet.connection_id() == connection_id);
 
-  std::shared_lock lock(mutex, std::try_to_lock);
-
-  if (!lock.owns_lock()) {
-    return;
-  }
+  bool closing;
 
   {
-    std::shared_lock lock(connections);
+    std::shared_lock lock(mutex, std::try_to_lock);
 
-    auto connections_iterator = connections.find(connection_id);
-
-    ASSERT(connections_iterator != connections.end());
-
-    auto& connection_details = connections_iterator->second;
+    if (!lock.owns_lock()) {
+      return;
+    }
 
     {
-      std::unique_lock lock(connection_details);
+      std::unique_lock lock(relay_target);
 
-      async_send_datagram(*socket, connection_details.source_endpoint, std::move(data));
+      async_send_datagram(*socket, relay_target.endpoint, std::move(data));
+
+      closing = relay_target.closing;
     }
   }
+
+  // The details of a closed connection wait for its last packets to be relayed.
+  if (closing) [[unlikely]] {
+    erase_connection(connection_id);
+  }
 }
 
-void ServerPrivate::async_wait_closing_timer_handler(ConnectionID connection_id) {
+void ServerPrivate::async_wait_sweep_timer_handler() {
   std::shared_lock lock(mutex, std::try_to_lock);
 
   if (!lock.owns_lock()) {
@@ -441,23 +682,23 @@ void ServerPrivate::async_wait_closing_timer_handler(ConnectionID connection_id)
   }
 
   {
-    std::unique_lock lock(connections);
-
-    auto connections_iterator = connections.find(connection_id);
+    std::unique_lock lock(tombstones);
 
-    ASSERT(connections_iterator != connections.end());
-
-    auto& connection_details = connections_iterator->second;
+    const auto now = std::chrono::steady_clock::now();
 
-    {
-      std::unique_lock lock(connection_details, std::try_to_lock);
-
-      ASSERT(lock.owns_lock());
+    while (!tombstones.buckets.empty() && tombstones.buckets.front().expiry <= now) {
+      for (auto connection_id : tombstones.buckets.front().connection_ids) {
+        tombstones.connection_ids.reset(connection_id);
+      }
 
-      ASSERT(connection_details.state == ConnectionDetails::State::Closing);
+      tombstones.buckets.pop_front();
     }
 
-    connections.erase(connections_iterator);
+    if (tombstones.buckets.empty()) {
+      tombstones.sweep_timer.reset();
+    } else {
+      start_sweep_timer(tombstones.buckets.front().expiry);
+    }
   }
 }
 
@@ -480,9 +721,15 @@ void ServerPrivate::state_changed_event_connection_handler(ConnectionID connecti
       auto& connection_details = connections_iterator->second;
 
       {
+        std::unique_lock closed_lock(closed_connections);
         std::unique_lock lock(connection_details);
 
-        if (connection_details.state == ConnectionDetails::State::Pending) {
+        accumulate_counters(closed_connections.statistics,
+                            connection_details.statistics->snapshot());
+
+        if (connection_details.state == ConnectionDetails::State::Connecting) {
+          handshakes_in_progress.fetch_sub(1, std::memory_order_relaxed);
+        } else if (connection_details.state == ConnectionDetails::State::Pending) {
           std::unique_lock lock(pending_connections);
 
           pending_connections.erase(connection_details.pending_connections_iterator);
@@ -492,8 +739,23 @@ void ServerPrivate::state_changed_event_connection_handler(ConnectionID connecti
 
         connection_details.state = ConnectionDetails::State::Closing;
 
-        start_closing_timer(connection_details, connection_id);
+        {
+          std::unique_lock lock(*connection_details.relay_target);
+
+          connection_details.relay_target->closing = true;
+        }
+
+        // The connection is still inside its own state change notification, so its details are
+        // released right after it returns. That happens on the strand of its relay, which may
+        // still have packets of the connection to send.
+        asio::post(connection_details.strand, [weak_self = weak_from_this(), connection_id]() {
+          if (auto self = weak_self.lock()) [[likely]] {
+            self->erase_connection(connection_id);
+          }
+        });
       }
+
+      bury_connection(connection_id);
     } break;
     case Connection::State::Established: {
       std::shared_lock lock(connections);
@@ -509,6 +771,8 @@ void ServerPrivate::state_changed_event_connection_handler(ConnectionID connecti
 
         ASSERT(connection_details.state == ConnectionDetails::State::Connecting);
 
+        handshakes_in_progress.fetch_sub(1, std::memory_order_relaxed);
+
         connection_details.state = ConnectionDetails::State::Pending;
 
         {
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <asio/ip/udp.hpp>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <optional>
 
+#include "connection.hpp"
 #include "utils/event.hpp"
 
 namespace protocol {
@@ -14,19 +17,42 @@ class ServerPrivate;
 
 }
 
-class Connection;
-
 class Server {
  public:
   using NewConnectionEvent = utils::Event<>;
 
  public:
+  // Token bucket per source address prefix, applied to incoming Initiations.
+  struct HandshakeRateLimit {
+    double burst;  // at least 1
+    uint8_t ipv4_prefix_length = 32;
+    uint8_t ipv6_prefix_length = 64;
+    double rate;  // handshakes per second
+  };
   struct Configuration {
     size_t backlog;
+    // Accepted connections are spread over these round-robin and stay on theirs for their whole
+    // lifetime, e.g. one io_context per core. The server's own io_context is used when empty.
+    std::vector<std::reference_wrapper<asio::io_context>> connection_io_contexts;
+    std::optional<HandshakeRateLimit> handshake_rate_limit;
+    std::optional<std::chrono::milliseconds> hibernation_interval;
     asio::ip::udp::endpoint local_endpoint;
+    std::optional<size_t> max_concurrent_handshakes;
+    // Applied to the outbound datagrams of every accepted connection, each seeded with seed mixed
+    // with its connection id.
+    std::optional<Connection::NetworkImpairment> network_impairment;
     std::optional<size_t> receive_buffer_size;
     std::vector<uint8_t> secret_key;
   };
+  struct Statistics {
+    size_t accepted_handshakes;
+    size_t connections;
+    size_t dropped_handshakes;  // backlog, concurrency cap or resource exhaustion
+    size_t limited_handshakes;  // rejected by the per-source rate limit
+    // Counters are summed over every connection since the server was opened, gauges over the live
+    // ones. cwnd and ssthresh are the smallest, rto, rttvar and srtt the largest of a live one.
+    Connection::Statistics transport;
+  };
 
  public:
   explicit Server(asio::io_context& io_context);
@@ -44,6 +70,8 @@ class Server {
 
   void open(Configuration&& config);
 
+  [[nodiscard]] Statistics statistics() const;
+
  public:
   [[nodiscard]] std::shared_ptr<NewConnectionEvent> new_connection() const;
 
@@ -4,17 +4,31 @@
 #include <asio/io_context_strand.hpp>
 #include <asio/ip/udp.hpp>
 #include <asio/steady_timer.hpp>
+#include <atomic>
+#include <bitset>
+#include <deque>
+#include <limits>
 #include <shared_mutex>
 #include <unordered_map>
 
 #include "connection.hpp"
 #include "detail/connection/api/types/connection_id.hpp"
+#include "detail/connection/connection_statistics.hpp"
+#include "detail/datagram_pool.hpp"
+#include "detail/server/handshake_rate_limiter.hpp"
 #include "server.hpp"
 
 namespace protocol {
 
 namespace detail {
 
+// Where the packets a connection sends are relayed to. Shared with the relay of its tx socket
+// pair, so packets already read from the pair still go out once its details are erased.
+struct RelayTarget : public std::mutex {
+  asio::ip::udp::endpoint endpoint;
+  bool closing = false;
+};
+
 struct ConnectionDetails : public std::recursive_mutex {
   ConnectionDetails(asio::io_context& io_context) : strand(io_context) {}
 
@@ -22,16 +36,32 @@ struct ConnectionDetails : public std::recursive_mutex {
 
   asio::io_context::strand strand;
 
+  // Handed out by next_pending_connection().
   std::shared_ptr<Connection> connection;
+  // Kept after the connection is handed out, its counters are folded into the server totals when
+  // it closes.
+  std::shared_ptr<const ConnectionStatistics> statistics;
   std::shared_ptr<Connection::StateChangedEvent::Subscription> state_changed_subscription;
 
   std::shared_ptr<asio::generic::datagram_protocol::socket> rx_socket_server;
   std::shared_ptr<asio::generic::datagram_protocol::socket> tx_socket_server;
-  asio::ip::udp::endpoint source_endpoint;
+  std::shared_ptr<RelayTarget> relay_target;
 
   std::list<ConnectionID>::iterator pending_connections_iterator;
+};
 
-  std::optional<asio::steady_timer> closing_timer;
+// Identifiers of closed connections are kept reserved for a while, so that late packets are
+// dropped instead of reaching a new connection that reuses the identifier. Expiries are rounded
+// up to buckets, which are swept in bulk by a single timer.
+struct Tombstones : public std::mutex {
+  struct Bucket {
+    std::chrono::steady_clock::time_point expiry;
+    std::vector<ConnectionID> connection_ids;
+  };
+
+  std::bitset<std::numeric_limits<ConnectionID>::max() + 1> connection_ids;
+  std::deque<Bucket> buckets;
+  std::optional<asio::steady_timer> sweep_timer;
 };
 
 class ServerPrivate : public std::enable_shared_from_this<ServerPrivate> {
@@ -39,20 +69,24 @@ class ServerPrivate : public std::enable_shared_from_this<ServerPrivate> {
   explicit ServerPrivate(asio::io_context& io_context);
   ~ServerPrivate();
 
-  void create_new_connection(std::vector<uint8_t>&& data, asio::ip::udp::endpoint&& endpoint);
+  void create_new_connection(DatagramSlice&& data, asio::ip::udp::endpoint&& endpoint);
+
+  void bury_connection(ConnectionID connection_id);
+
+  void erase_connection(ConnectionID connection_id);
 
-  void redirect_encrypted_packet(std::vector<uint8_t>&& data, asio::ip::udp::endpoint&& endpoint);
+  void redirect_encrypted_packet(DatagramSlice&& data, asio::ip::udp::endpoint&& endpoint);
 
-  void start_closing_timer(ConnectionDetails& connection_details, ConnectionID connection_id);
+  void start_sweep_timer(std::chrono::steady_clock::time_point expiry);
 
  public:
-  void async_receive_socket_handler(std::vector<uint8_t> data, asio::ip::udp::endpoint endpoint);
+  void async_receive_socket_handler(DatagramSlice data, asio::ip::udp::endpoint endpoint);
 
   void async_receive_tx_socket_server_handler(
-      ConnectionID connection_id, std::vector<uint8_t> data,
+      ConnectionID connection_id, RelayTarget& relay_target, DatagramSlice data,
       const asio::generic::datagram_protocol::endpoint& endpoint);
 
-  void async_wait_closing_timer_handler(ConnectionID connection_id);
+  void async_wait_sweep_timer_handler();
 
   void state_changed_event_connection_handler(ConnectionID connection_id,
                                               Connection::State new_state);
@@ -62,6 +96,11 @@ class ServerPrivate : public std::enable_shared_from_this<ServerPrivate> {
   std::shared_mutex mutex;
 
   size_t backlog;
+  std::vector<std::reference_wrapper<asio::io_context>> connection_io_contexts;
+  std::optional<HandshakeRateLimiter> handshake_rate_limiter;
+  std::optional<std::chrono::milliseconds> hibernation_interval;
+  std::optional<size_t> max_concurrent_handshakes;
+  std::optional<Connection::NetworkImpairment> network_impairment;
   std::vector<uint8_t> secret_key;
   std::shared_ptr<asio::ip::udp::socket> socket;
 
@@ -70,6 +109,19 @@ class ServerPrivate : public std::enable_shared_from_this<ServerPrivate> {
   } connections;
   struct : std::list<ConnectionID>, std::recursive_mutex {
   } pending_connections;
+  Tombstones tombstones;
+  // Counters of the connections closed so far, so the server totals never go backwards.
+  struct : std::mutex {
+    Connection::Statistics statistics{};
+  } closed_connections;
+
+  std::atomic<size_t> handshakes_in_progress;
+  std::atomic<size_t> next_connection_io_context;
+  struct {
+    std::atomic<size_t> accepted_handshakes;
+    std::atomic<size_t> dropped_handshakes;
+    std::atomic<size_t> limited_handshakes;
+  } statistics;
 
   std::shared_ptr<Server::NewConnectionEvent> new_connection_event;
 };
@@ -1,6 +1,7 @@
 #include "connection_p.hpp"
 #include "detail/connection/api/structures/payload_data.hpp"
 #include "stream_p.hpp"
+#include "utils/debug/assert.hpp"
 #include "utils/span/copy.hpp"
 
 namespace protocol {
@@ -14,13 +15,13 @@ Stream::Stream(ConnectionPrivate &connection_private, StreamIdentifier &stream_i
 Stream::~Stream() = default;
 
 bool Stream::is_readable() const {
-  std::unique_lock lock(impl_->connection_private.mutex);
+  ASSERT(impl_->connection_private.strand.running_in_this_thread());
 
   return impl_->is_readable_unordered() || impl_->is_readable_ordered();
 }
 
 std::optional<std::vector<uint8_t>> Stream::read() {
-  std::unique_lock lock(impl_->connection_private.mutex);
+  ASSERT(impl_->connection_private.strand.running_in_this_thread());
 
   if (impl_->is_readable_unordered()) {
     auto result = std::move(impl_->unordered_queue.front());
@@ -39,55 +40,30 @@ std::optional<std::vector<uint8_t>> Stream::read() {
 
 void Stream::set_reliability_params(bool unordered, ReliabilityType rel_type,
                                     ReliabilityValue rel_val) {
-  std::unique_lock lock(impl_->connection_private.mutex);
-
-  impl_->unordered = unordered;
-  impl_->reliability_type = rel_type;
-  impl_->reliability_value = rel_val;
+  impl_->connection_private.command_queue.push(
+      command::SetReliabilityParams{impl_->stream_identifier, unordered, rel_type, rel_val});
 }
 
 void Stream::write(std::span<const uint8_t> message) {
+  write(std::vector<uint8_t>(message.begin(), message.end()));
+}
+
+void Stream::write(std::vector<uint8_t>&& message) {
   if (message.empty()) {
     return;
   }
 
-  std::unique_lock lock(impl_->connection_private.mutex);
+  impl_->connection_private.command_queue.push(
+      command::Write{impl_->stream_identifier, std::move(message)});
+}
 
-  if (impl_->connection_private.state_manager.any_of(
-          Connection::State::ShutdownPending, Connection::State::ShutdownSent,
-          Connection::State::ShutdownReceived, Connection::State::ShutdownAckSent)) {
+void Stream::write(std::shared_ptr<const std::vector<uint8_t>> message) {
+  if (message == nullptr || message->empty()) {
     return;
   }
 
-  const size_t cached_max_payload_size = impl_->max_payload_size();
-
-  size_t offset = 0;
-
-  while (offset != message.size()) {
-    auto fragment =
-        message.subspan(offset, std::min(cached_max_payload_size, message.size() - offset));
-
-    auto buffer =
-        serialization::BufferBuilder<PayloadData>{}.set_data_size(fragment.size()).build();
-
-    PayloadData payload_data(buffer);
-
-    payload_data.bits().b = (offset == 0);
-    offset += fragment.size();
-    payload_data.bits().e = (offset == message.size());
-    payload_data.bits().u = impl_->unordered;
-
-    payload_data.sid() = impl_->stream_identifier;
-    payload_data.ssn() = impl_->sequence_number;
-
-    utils::span::copy<uint8_t>(payload_data.data(), fragment);
-
-    impl_->connection_private.out_data_queue.push(std::move(buffer));
-  }
-
-  ++impl_->sequence_number;
-
-  impl_->connection_private.network_manager.write_pending_packets();
+  impl_->connection_private.command_queue.push(
+      command::Write{impl_->stream_identifier, std::move(message)});
 }
 
 StreamPrivate::StreamPrivate(ConnectionPrivate &connection_private,
@@ -133,4 +109,41 @@ size_t StreamPrivate::max_payload_size() const {
           serialization::BufferBuilder<PayloadData>{}.set_data_size(0).buffer_size());
 }
 
+void StreamPrivate::reset() {
+  next_ssn = std::numeric_limits<StreamSequenceNumber::value_type>::min();
+  ordered_queue.clear();
+  sequence_number = std::numeric_limits<StreamSequenceNumber::value_type>::min();
+  unordered_queue.clear();
+}
+
+void StreamPrivate::write(std::span<const uint8_t> message) {
+  const size_t cached_max_payload_size = max_payload_size();
+
+  size_t offset = 0;
+
+  while (offset != message.size()) {
+    auto fragment =
+        message.subspan(offset, std::min(cached_max_payload_size, message.size() - offset));
+
+    auto buffer =
+        serialization::BufferBuilder<PayloadData>{}.set_data_size(fragment.size()).build();
+
+    PayloadData payload_data(buffer);
+
+    payload_data.bits().b = (offset == 0);
+    offset += fragment.size();
+    payload_data.bits().e = (offset == message.size());
+    payload_data.bits().u = unordered;
+
+    payload_data.sid() = stream_identifier;
+    payload_data.ssn() = sequence_number;
+
+    utils::span::copy<uint8_t>(payload_data.data(), fragment);
+
+    connection_private.out_data_queue.push(std::move(buffer));
+  }
+
+  ++sequence_number;
+}
+
 }  // namespace protocol
@@ -29,10 +29,12 @@ class Stream {
   explicit Stream(Args&&... args);
   ~Stream();
 
+  // Must be called on the connection strand, e.g. from a ready_read handler.
   [[nodiscard]] bool is_readable() const;
 
   [[nodiscard]] size_t max_message_size() const;
 
+  // Must be called on the connection strand, e.g. from a ready_read handler.
   std::optional<std::vector<uint8_t>> read();
 
   [[nodiscard]] ReliabilityType rel_type() const;
@@ -45,6 +47,12 @@ class Stream {
 
   void write(std::span<const uint8_t> message);
 
+  void write(std::vector<uint8_t>&& message);
+
+  // The message may be shared by any number of streams, e.g. an event broadcast to many
+  // connections, and is only read once it reaches the connection strand.
+  void write(std::shared_ptr<const std::vector<uint8_t>> message);
+
  private:
   const std::unique_ptr<detail::StreamPrivate> impl_;
 
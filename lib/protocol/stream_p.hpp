@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <list>
 #include <map>
+#include <span>
 #include <vector>
 
 #include "detail/connection/api/types/stream_identifier.hpp"
@@ -30,6 +31,11 @@ class StreamPrivate {
 
   [[nodiscard]] size_t max_payload_size() const;
 
+  // Drops the data of the previous association, the reliability params are kept.
+  void reset();
+
+  void write(std::span<const uint8_t> message);
+
  public:
   ConnectionPrivate &connection_private;
 
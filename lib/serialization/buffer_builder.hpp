@@ -2,6 +2,8 @@
 
 #include <cstddef>
 
+#include "buffer_pool.hpp"
+
 namespace serialization {
 
 template <size_t I>
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace serialization {
+
+// Thread-local free lists of byte buffers, bucketed by power of two capacity. Buffers keep their
+// capacity while pooled, so a steady stream of similarly sized datagrams stops hitting the
+// allocator. A buffer may be released on a different thread than the one that acquired it.
+//
+// Only the allocation is saved, not the zero-fill: std::vector value-initializes what it grows by,
+// and pooled buffers are emptied so that no bytes of a previous owner are handed out again.
+class BufferPool {
+ private:
+  static constexpr size_t MIN_CAPACITY_LOG2 = 6;
+  static constexpr size_t MAX_CAPACITY_LOG2 = 16;
+  static constexpr size_t MAX_BUFFERS_PER_CLASS = 32;
+
+  static constexpr size_t CLASS_COUNT = MAX_CAPACITY_LOG2 - MIN_CAPACITY_LOG2 + 1;
+
+  struct SizeClass {
+    std::array<std::vector<uint8_t>, MAX_BUFFERS_PER_CLASS> buffers;
+    size_t size = 0;
+  };
+
+ public:
+  // Zero-filled buffer of the given size.
+  static std::vector<uint8_t> acquire(size_t size) {
+    auto buffer = take(size);
+
+    buffer.resize(size);
+
+    return buffer;
+  }
+
+  static void release(std::vector<uint8_t>&& buffer) {
+    const size_t capacity = buffer.capacity();
+
+    if (capacity < (size_t(1) << MIN_CAPACITY_LOG2)) {
+      return;
+    }
+
+    // Largest class the capacity fully covers.
+    const size_t log2 = std::bit_width(capacity) - 1;
+
+    if (log2 > MAX_CAPACITY_LOG2) {
+      return;
+    }
+
+    auto& size_class = size_classes()[log2 - MIN_CAPACITY_LOG2];
+
+    if (size_class.size == MAX_BUFFERS_PER_CLASS) {
+      return;
+    }
+
+    buffer.clear();
+
+    size_class.buffers[size_class.size++] = std::move(buffer);
+  }
+
+ private:
+  static std::vector<uint8_t> take(size_t size) {
+    const size_t log2 = std::max(MIN_CAPACITY_LOG2, size_t(std::bit_width(size - (size != 0))));
+
+    std::vector<uint8_t> buffer;
+
+    if (log2 <= MAX_CAPACITY_LOG2) [[likely]] {
+      auto& size_class = size_classes()[log2 - MIN_CAPACITY_LOG2];
+
+      if (size_class.size != 0) [[likely]] {
+        return std::move(size_class.buffers[--size_class.size]);
+      }
+
+      buffer.reserve(size_t(1) << log2);
+    }
+
+    return buffer;
+  }
+
+  static std::array<SizeClass, CLASS_COUNT>& size_classes() {
+    thread_local std::array<SizeClass, CLASS_COUNT> size_classes;
+
+    return size_classes;
+  }
+};
+
+}  // namespace serialization
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+
+#include "packed_struct.hpp"
+
+namespace serialization {
+
+namespace field {
+
+// Field of a constant size: PackedInteger, PackedEnum, PackedStaticArray or any other packed type.
+template <typename T>
+struct Fixed {
+  using type = T;
+
+  static constexpr bool is_dynamic = false;
+  static constexpr bool is_tail = false;
+  static constexpr size_t static_size = sizeof(T);
+
+  static_assert(std::alignment_of_v<T> == 1);
+  static_assert(std::is_standard_layout_v<T>);
+};
+
+// PackedDynamicArray, its size prefix is counted statically and its data dynamically.
+template <typename T>
+struct Dynamic {
+  using type = T;
+
+  static constexpr bool is_dynamic = true;
+  static constexpr bool is_tail = false;
+  static constexpr size_t static_size = sizeof(typename T::size_type);
+
+  static size_t dynamic_size(const uint8_t *data) noexcept {
+    return sizeof(typename T::data_type) *
+           reinterpret_cast<const typename T::size_type *>(data)->value();
+  }
+};
+
+// Array of T spanning the rest of the buffer, must be the last field.
+template <typename T>
+struct Tail {
+  using type = std::span<T>;
+
+  static constexpr bool is_dynamic = false;
+  static constexpr bool is_tail = true;
+  static constexpr size_t static_size = 0;
+
+  static_assert(std::alignment_of_v<T> == 1);
+};
+
+}  // namespace field
+
+// Compile-time description of a packed wire struct. Offsets of fields that are not preceded by a
+// dynamic field are constants; the rest add one size prefix load per preceding dynamic field.
+template <typename... Fields>
+class PackedLayout {
+ public:
+  static constexpr size_t size = sizeof...(Fields);
+  static constexpr size_t static_size = (Fields::static_size + ... + 0);
+
+  template <size_t I>
+  using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+ public:
+  template <size_t I>
+  static size_t offset(const uint8_t *data) noexcept {
+    if constexpr (I == 0) {
+      return 0;
+    } else {
+      using previous_type = field_type<I - 1>;
+
+      const size_t previous_offset = offset<I - 1>(data);
+
+      if constexpr (previous_type::is_dynamic) {
+        return previous_offset + previous_type::static_size +
+               previous_type::dynamic_size(data + previous_offset);
+      } else {
+        return previous_offset + previous_type::static_size;
+      }
+    }
+  }
+
+  // One comparison for all fixed fields plus one per dynamic field. A size prefix is only loaded
+  // once everything in front of it is known to be in range.
+  static bool validate(const uint8_t *data, size_t raw_size) noexcept {
+    return validate<0>(data, raw_size, static_size);
+  }
+
+ private:
+  template <size_t I>
+  static bool validate(const uint8_t *data, size_t raw_size, size_t required_size) noexcept {
+    if constexpr (I == size) {
+      return required_size <= raw_size;
+    } else if constexpr (field_type<I>::is_dynamic) {
+      if (required_size > raw_size) [[unlikely]] {
+        return false;
+      }
+
+      return validate<I + 1>(data, raw_size,
+                             required_size + field_type<I>::dynamic_size(data + offset<I>(data)));
+    } else {
+      return validate<I + 1>(data, raw_size, required_size);
+    }
+  }
+};
+
+// Base of wire structs described by Derived::layout_type. Accessors and validate() are resolved
+// statically, there is no vtable involved.
+template <typename Derived>
+class PackedLayoutStruct : public PackedStruct {
+ public:
+  using PackedStruct::PackedStruct;
+
+  bool validate() noexcept { return Derived::layout_type::validate(bytes(), raw_size()); }
+
+ protected:
+  template <size_t I>
+  decltype(auto) get() noexcept {
+    using layout_type = typename Derived::layout_type;
+    using field_type = typename layout_type::template field_type<I>;
+    using type = typename field_type::type;
+
+    const size_t offset = layout_type::template offset<I>(bytes());
+
+    if constexpr (field_type::is_tail) {
+      static_assert(I + 1 == layout_type::size, "tail field must be the last one");
+
+      return type(jmp_ptr<typename type::value_type>(offset),
+                  (raw_size() - offset) / sizeof(typename type::value_type));
+    } else {
+      return jmp_ref<type>(offset);
+    }
+  }
+
+ private:
+  const uint8_t *bytes() const noexcept { return static_cast<const uint8_t *>(raw_data()); }
+};
+
+}  // namespace serialization
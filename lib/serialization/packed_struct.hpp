@@ -18,8 +18,6 @@ class PackedStruct {
 
   size_t raw_size() const noexcept { return raw_size_; }
 
-  virtual bool validate() = 0;
-
  protected:
   bool range_check(size_t offset, size_t size) const noexcept { return offset + size <= raw_size_; }
 
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace utils {
+
+// Unbounded multi-producer single-consumer queue (Vyukov's node based algorithm). push() is
+// wait-free and may be called from any thread, pop() must only be called by one consumer at a
+// time. A push that is still in progress may be invisible to pop(), so consumers are expected to
+// be re-scheduled by producers after their push completes.
+template <typename T>
+class MpscQueue {
+ private:
+  struct Node {
+    std::atomic<Node*> next = nullptr;
+    std::optional<T> value;
+  };
+
+ public:
+  MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+  ~MpscQueue() {
+    while (pop().has_value()) {
+    }
+    delete tail_;
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  std::optional<T> pop() {
+    auto* tail = tail_;
+    auto* next = tail->next.load(std::memory_order_acquire);
+
+    if (next == nullptr) {
+      return std::nullopt;
+    }
+
+    std::optional<T> result(std::move(next->value));
+
+    next->value.reset();
+    tail_ = next;
+
+    delete tail;
+
+    return result;
+  }
+
+  void push(T value) {
+    auto* node = new Node();
+
+    node->value.emplace(std::move(value));
+
+    auto* prev = head_.exchange(node, std::memory_order_acq_rel);
+
+    prev->next.store(node, std::memory_order_release);
+  }
+
+ private:
+  std::atomic<Node*> head_;
+  Node* tail_;
+};
+
+}  // namespace utils
@@ -7,9 +7,10 @@ class Parentable {
  protected:
   using parent_type = Parent;
 
+  ~Parentable() = default;
+
  public:
   explicit Parentable(Parent& parent) : parent_(parent) {}
-  virtual ~Parentable() = default;
 
   const Parent& parent() const noexcept { return parent_; }
 
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "debug/assert.hpp"
+
+namespace utils {
+
+template <typename Signature, size_t Capacity = 4 * sizeof(void*)>
+class SmallFunction;
+
+// Move-only std::function replacement. Callables of up to Capacity bytes that are nothrow move
+// constructible are stored inline, so wrapping a lambda with a few captures does not allocate;
+// larger ones are kept on the heap.
+template <typename R, typename... Args, size_t Capacity>
+class SmallFunction<R(Args...), Capacity> {
+ public:
+  SmallFunction() noexcept = default;
+
+  SmallFunction(std::nullptr_t /*unused*/) noexcept {}
+
+  template <typename F>
+  requires(!std::is_same_v<std::decay_t<F>, SmallFunction> &&
+           std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+  SmallFunction(F&& function) {
+    using T = std::decay_t<F>;
+
+    if constexpr (is_inline<T>) {
+      new (&storage_) T(std::forward<F>(function));
+    } else {
+      new (&storage_) T*(new T(std::forward<F>(function)));
+    }
+
+    vtable_ = &VTABLE<T>;
+  }
+
+  SmallFunction(const SmallFunction&) = delete;
+
+  SmallFunction(SmallFunction&& other) noexcept : vtable_(std::exchange(other.vtable_, nullptr)) {
+    if (vtable_ != nullptr) {
+      vtable_->move(&storage_, &other.storage_);
+    }
+  }
+
+  ~SmallFunction() { reset(); }
+
+  SmallFunction& operator=(const SmallFunction&) = delete;
+
+  SmallFunction& operator=(SmallFunction&& other) noexcept {
+    if (this != &other) {
+      reset();
+
+      vtable_ = std::exchange(other.vtable_, nullptr);
+
+      if (vtable_ != nullptr) {
+        vtable_->move(&storage_, &other.storage_);
+      }
+    }
+
+    return *this;
+  }
+
+  SmallFunction& operator=(std::nullptr_t /*unused*/) noexcept {
+    reset();
+
+    return *this;
+  }
+
+  R operator()(Args... args) {
+    ASSERT_X(vtable_ != nullptr, "bad function call");
+
+    return vtable_->invoke(&storage_, std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+  friend bool operator==(const SmallFunction& function, std::nullptr_t /*unused*/) noexcept {
+    return function.vtable_ == nullptr;
+  }
+
+ private:
+  struct VTable {
+    R (*invoke)(void* storage, Args&&... args);
+    // Move constructs into to and destroys what is left in from.
+    void (*move)(void* to, void* from) noexcept;
+    void (*destroy)(void* storage) noexcept;
+  };
+
+  template <typename T>
+  static constexpr bool is_inline = sizeof(T) <= Capacity &&
+                                    alignof(T) <= alignof(std::max_align_t) &&
+                                    std::is_nothrow_move_constructible_v<T>;
+
+  template <typename T>
+  static T& get(void* storage) noexcept {
+    if constexpr (is_inline<T>) {
+      return *std::launder(static_cast<T*>(storage));
+    } else {
+      return **std::launder(static_cast<T**>(storage));
+    }
+  }
+
+  template <typename T>
+  static constexpr VTable VTABLE = {
+      [](void* storage, Args&&... args) -> R {
+        return std::invoke(get<T>(storage), std::forward<Args>(args)...);
+      },
+      [](void* to, void* from) noexcept {
+        if constexpr (is_inline<T>) {
+          new (to) T(std::move(get<T>(from)));
+
+          get<T>(from).~T();
+        } else {
+          new (to) T*(*std::launder(static_cast<T**>(from)));
+        }
+      },
+      [](void* storage) noexcept {
+        if constexpr (is_inline<T>) {
+          get<T>(storage).~T();
+        } else {
+          delete &get<T>(storage);
+        }
+      }};
+
+  void reset() noexcept {
+    if (vtable_ != nullptr) {
+      std::exchange(vtable_, nullptr)->destroy(&storage_);
+    }
+  }
+
+ private:
+  const VTable* vtable_ = nullptr;
+  alignas(std::max_align_t) std::byte storage_[Capacity];
+};
+
+}  // namespace utils
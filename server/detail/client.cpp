@@ -1,6 +1,6 @@
 #include "client.hpp"
 
-#include <api/request.pb.h>
+#include <api/exception_code.pb.h>
 
 #include "server_impl.hpp"
 
@@ -9,7 +9,35 @@ namespace detail {
 Client::Client(uint64_t id, std::shared_ptr<protocol::Connection>&& connection)
     : id_(id), connection_(std::move(connection)), authorized_(false) {
   ASSERT(connection_ != nullptr);
+}
+
+Client::~Client() = default;
+
+const communication::Server& Client::communication() const { return communication_; }
+
+communication::Server& Client::communication() { return communication_; }
+
+uint32_t Client::device_id() const {
+  ASSERT(authorized_);
+
+  return device_id_;
+}
+
+void Client::dispatch(std::function<void(Client&)> function) {
+  connection_->dispatch([weak_self = weak_from_this(), function = std::move(function)]() {
+    if (auto self = weak_self.lock()) [[likely]] {
+      function(*self);
+    }
+  });
+}
+
+uint64_t Client::id() const { return id_; }
+
+asio::io_context& Client::io_context() const { return connection_->io_context(); }
 
+bool Client::is_authorized() const { return authorized_; }
+
+void Client::open() {
   state_changed_subscription_ = connection_->state_changed()->subscribe(
       [weak_self = weak_from_this()]([[maybe_unused]] auto&&... args) {
         if (auto self = weak_self.lock()) {
@@ -33,22 +61,6 @@ Client::Client(uint64_t id, std::shared_ptr<protocol::Connection>&& connection)
   communication_.open(connection_);
 }
 
-Client::~Client() = default;
-
-const communication::Server& Client::communication() const { return communication_; }
-
-communication::Server& Client::communication() { return communication_; }
-
-uint32_t Client::device_id() const {
-  ASSERT(authorized_);
-
-  return device_id_;
-}
-
-uint64_t Client::id() const { return id_; }
-
-bool Client::is_authorized() const { return authorized_; }
-
 uint64_t Client::user_id() const {
   ASSERT(authorized_);
 
@@ -60,12 +72,13 @@ void Client::new_raw_data_event_communication_handler() {
 }
 
 void Client::new_request_event_communication_handler() {
+  auto& request_scheduler = ServerImpl::instance().request_scheduler;
+
   while (auto pair_opt = communication_.next_pending_request()) {
     auto& [id, data] = *pair_opt;
 
-    api::Request request;
-    if (request.ParseFromArray(data.data(), data.size())) {
-      ServerImpl::instance().request_handler.handle(*this, id, request);
+    if (!request_scheduler.schedule(shared_from_this(), id, std::move(data))) [[unlikely]] {
+      communication_.try_send_exception(id, api::ExceptionCode::TOO_MANY_REQUESTS);
     }
   }
 }
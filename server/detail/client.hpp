@@ -9,7 +9,7 @@ namespace detail {
 
 class ClientManager;
 
-class Client : std::enable_shared_from_this<Client> {
+class Client : public std::enable_shared_from_this<Client> {
  public:
   explicit Client(uint64_t id, std::shared_ptr<protocol::Connection>&& connection);
   Client(const Client&) = delete;
@@ -21,10 +21,20 @@ class Client : std::enable_shared_from_this<Client> {
 
   [[nodiscard]] uint32_t device_id() const;
 
+  // Runs function on the shard the client lives on, inline when already there. This is the
+  // only way to act on a client from another shard.
+  void dispatch(std::function<void(Client&)> function);
+
   [[nodiscard]] uint64_t id() const;
 
+  // The shard the client lives on.
+  [[nodiscard]] asio::io_context& io_context() const;
+
   [[nodiscard]] bool is_authorized() const;
 
+  // Starts handling the connection, once the client is owned by a shared_ptr.
+  void open();
+
   [[nodiscard]] uint64_t user_id() const;
 
  private:
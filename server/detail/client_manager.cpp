@@ -1,40 +1,98 @@
 #include "client_manager.hpp"
 
+#include <asio/dispatch.hpp>
+#include <stdexcept>
+
+#include "server_impl.hpp"
+
 namespace detail {
 
+namespace {
+
+metrics::Gauge& active_clients() {
+  static auto& gauge = ServerImpl::instance().metrics_manager.gauge(
+      "neutron_connections_active", "Clients with an open connection");
+
+  return gauge;
+}
+
+}  // namespace
+
 void ClientManager::add_unauthorized(std::shared_ptr<protocol::Connection>&& connection) {
   ASSERT(connection != nullptr);
 
-  std::unique_lock lock(mutex_);
+  std::shared_ptr<Client> client;
+
+  {
+    std::unique_lock lock(mutex_);
 
-  uint64_t id;
+    uint64_t id;
 
-  do {
-    id = client_list_.next_id++;
-  } while (client_id_map_.contains(id));
+    do {
+      id = client_list_.next_id++;
+    } while (client_id_map_.contains(id));
 
-  auto client_list_iterator =
-      client_list_.insert(client_list_.end(), std::make_shared<Client>(id, std::move(connection)));
+    client = std::make_shared<Client>(id, std::move(connection));
 
-  auto [client_id_map_iterator, success] = client_id_map_.try_emplace(id, client_list_iterator);
+    auto client_list_iterator = client_list_.insert(client_list_.end(), client);
 
-  ASSERT(success);
+    auto [client_id_map_iterator, success] = client_id_map_.try_emplace(id, client_list_iterator);
+
+    ASSERT(success);
+  }
+
+  active_clients().add();
+
+  client->open();
 }
 
-void ClientManager::do_for_each(uint64_t user_id, const std::function<void(Client&)>& function,
-                                const std::optional<uint64_t> exclude_client) const {
-  std::shared_lock lock(mutex_);
+void ClientManager::broadcast(const std::vector<uint64_t>& user_ids,
+                              communication::Server::SharedEvent event,
+                              const std::optional<uint64_t> exclude_client) const {
+  auto& metrics_manager = ServerImpl::instance().metrics_manager;
+
+  static auto& fan_outs = metrics_manager.counter("neutron_event_fan_outs_total",
+                                                  "Events fanned out to the clients of users");
+  static auto& fan_out_size = metrics_manager.histogram(
+      "neutron_event_fan_out_clients", "Clients an event was delivered to per fan-out", 1.0);
+
+  std::unordered_map<asio::io_context*, std::vector<std::shared_ptr<Client>>> shards;
 
-  auto client_user_id_map_iterator_pair = client_user_id_map_.equal_range(user_id);
+  uint64_t delivered = 0;
+
+  {
+    std::shared_lock lock(mutex_);
 
-  for (auto iterator = client_user_id_map_iterator_pair.first;
-       iterator != client_user_id_map_iterator_pair.second; ++iterator) {
-    auto& client = *(*iterator->second);
+    for (auto user_id : user_ids) {
+      auto client_user_id_map_iterator_pair = client_user_id_map_.equal_range(user_id);
 
-    if (exclude_client != client.id()) {
-      function(client);
+      for (auto iterator = client_user_id_map_iterator_pair.first;
+           iterator != client_user_id_map_iterator_pair.second; ++iterator) {
+        const auto& client = *iterator->second;
+
+        if (exclude_client != client->id()) {
+          shards[&client->io_context()].push_back(client);
+
+          ++delivered;
+        }
+      }
     }
   }
+
+  for (auto& [io_context, clients] : shards) {
+    asio::dispatch(*io_context, [clients = std::move(clients), event]() {
+      for (const auto& client : clients) {
+        try {
+          client->communication().send_event(communication::Server::EVENT_STREAM, event);
+        } catch (const std::runtime_error&) {
+          // Closed in the meantime, the client is about to be removed.
+        }
+      }
+    });
+  }
+
+  fan_outs.add();
+  fan_out_size.record(delivered);
 }
 
 std::shared_ptr<Client> ClientManager::find(uint64_t user_id, uint32_t device_id) const {
@@ -140,6 +198,27 @@ void ClientManager::remove(uint64_t client_id) {
   }
 
   client_list_.erase(client_list_iterator);
+  client_id_map_.erase(client_id_map_iterator);
+
+  active_clients().sub();
+}
+
+std::optional<uint64_t> ClientManager::user_id(uint64_t client_id) const {
+  std::shared_lock lock(mutex_);
+
+  auto client_id_map_iterator = client_id_map_.find(client_id);
+
+  if (client_id_map_iterator == client_id_map_.end()) {
+    return std::nullopt;
+  }
+
+  auto& client = *client_id_map_iterator->second;
+
+  if (!client->authorized_) {
+    return std::nullopt;
+  }
+
+  return client->user_id_;
 }
 
 }  // namespace detail
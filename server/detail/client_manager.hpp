@@ -1,7 +1,9 @@
 #pragma once
 
+#include <optional>
 #include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "client.hpp"
 #include "utils/pair/hasher.hpp"
@@ -12,8 +14,11 @@ class ClientManager {
  public:
   void add_unauthorized(std::shared_ptr<protocol::Connection>&& connection);
 
-  void do_for_each(uint64_t user_id, const std::function<void(Client&)>& function,
-                   const std::optional<uint64_t> exclude_client = std::nullopt) const;
+  // Sends the event to every client of the users. The clients are grouped by shard and every
+  // shard gets a single handler sending to all of its clients; the event is framed once and
+  // shared by all of them.
+  void broadcast(const std::vector<uint64_t>& user_ids, communication::Server::SharedEvent event,
+                 const std::optional<uint64_t> exclude_client = std::nullopt) const;
 
   [[nodiscard]] std::shared_ptr<Client> find(uint64_t user_id, uint32_t device_id) const;
 
@@ -23,6 +28,10 @@ class ClientManager {
 
   void remove(uint64_t client_id);
 
+  // The user the client is signed in as. Clients are signed in and out by the workers, so this is
+  // the way to read it from elsewhere.
+  [[nodiscard]] std::optional<uint64_t> user_id(uint64_t client_id) const;
+
  private:
   mutable std::shared_mutex mutex_;
 
@@ -1,18 +1,138 @@
 #include "database_manager.hpp"
 
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
 #include <pqxx/pqxx>
+#include <string>
+#include <utility>
+
+#include "server_impl.hpp"
+#include "utils/debug/assert.hpp"
 
 namespace detail {
 
-pqxx::connection& DatabaseManager::connection() {
-  static thread_local pqxx::connection connection(connection_string_);
-  return connection;
+namespace {
+
+// A connection idle for longer is checked before it is handed out, the server or something in
+// between may have dropped it meanwhile.
+constexpr auto HEALTH_CHECK_INTERVAL = std::chrono::seconds(30);
+
+std::vector<const DatabaseManager::Statement*>& statements() {
+  static std::vector<const DatabaseManager::Statement*> statements;
+  return statements;
+}
+
+}  // namespace
+
+thread_local DatabaseManager::Slot* DatabaseManager::borrowed_slot_ = nullptr;
+
+DatabaseManager::Statement::Statement(std::string name, std::string query)
+    : name_(std::move(name)), query_(std::move(query)) {
+  statements().push_back(this);
+}
+
+const std::string& DatabaseManager::Statement::name() const { return name_; }
+
+const std::string& DatabaseManager::Statement::query() const { return query_; }
+
+DatabaseManager::Connection::Connection(DatabaseManager& manager, Pool* pool, Slot* slot)
+    : manager_(manager), pool_(pool), slot_(slot) {}
+
+DatabaseManager::Connection::Connection(Connection&& other) noexcept
+    : manager_(other.manager_),
+      pool_(std::exchange(other.pool_, nullptr)),
+      slot_(std::exchange(other.slot_, nullptr)) {}
+
+DatabaseManager::Connection::~Connection() {
+  if (pool_ != nullptr) {
+    borrowed_slot_ = nullptr;
+
+    manager_.release(*pool_, *slot_);
+  }
+}
+
+pqxx::connection& DatabaseManager::Connection::operator*() const { return *slot_->connection; }
+
+pqxx::connection* DatabaseManager::Connection::operator->() const {
+  return slot_->connection.get();
+}
+
+DatabaseManager::DatabaseManager() : reconnects_(nullptr), wait_duration_(nullptr) {}
+
+DatabaseManager::~DatabaseManager() = default;
+
+void DatabaseManager::configure(const std::vector<size_t>& pool_sizes) {
+  ASSERT(pools_.empty());
+  ASSERT(!pool_sizes.empty());
+
+  auto& metrics_manager = ServerImpl::instance().metrics_manager;
+
+  reconnects_ = &metrics_manager.counter("neutron_database_reconnects_total",
+                                         "Database connections reopened after breaking");
+  wait_duration_ = &metrics_manager.histogram("neutron_database_connection_wait_seconds",
+                                              "Time to borrow a database connection", 1e-6);
+
+  pools_.reserve(pool_sizes.size());
+
+  for (auto pool_size : pool_sizes) {
+    ASSERT(pool_size != 0);
+
+    auto& pool = *pools_.emplace_back(std::make_unique<Pool>());
+
+    pool.slots.reserve(pool_size);
+    pool.idle_slots.reserve(pool_size);
+
+    for (size_t i = 0; i < pool_size; ++i) {
+      auto& slot = *pool.slots.emplace_back(std::make_unique<Slot>());
+
+      open(slot);
+
+      pool.idle_slots.push_back(&slot);
+    }
+  }
+}
+
+DatabaseManager::Connection DatabaseManager::connection() {
+  ASSERT(!pools_.empty());
+
+  if (borrowed_slot_ != nullptr) {
+    return Connection(*this, nullptr, borrowed_slot_);
+  }
+
+  auto& pool = *pools_[std::min(WorkerManager::current_pool(), pools_.size() - 1)];
+
+  Slot* slot;
+
+  {
+    const auto timer = wait_duration_->time();
+
+    std::unique_lock lock(pool.mutex);
+
+    pool.available.wait(lock, [&pool]() { return !pool.idle_slots.empty(); });
+
+    slot = pool.idle_slots.back();
+    pool.idle_slots.pop_back();
+  }
+
+  try {
+    ensure_healthy(*slot);
+  } catch (...) {
+    release(pool, *slot);
+    throw;
+  }
+
+  borrowed_slot_ = slot;
+
+  return Connection(*this, &pool, slot);
 }
 
 const std::string& DatabaseManager::connection_string() const { return connection_string_; }
 
 void DatabaseManager::create_tables() {
-  pqxx::work transaction(connection());
+  // Runs once at startup, before the pools are opened.
+  pqxx::connection connection(connection_string_);
+  pqxx::work transaction(connection);
 
   transaction.exec(
       "CREATE TABLE IF NOT EXISTS chats ("
@@ -84,4 +204,57 @@ void DatabaseManager::set_connection_string(std::string string) {
   connection_string_ = std::move(string);
 }
 
+void DatabaseManager::ensure_healthy(Slot& slot) {
+  if (slot.connection != nullptr && slot.connection->is_open()) [[likely]] {
+    if (std::chrono::steady_clock::now() - slot.last_used < HEALTH_CHECK_INTERVAL) [[likely]] {
+      return;
+    }
+
+    try {
+      pqxx::nontransaction transaction(*slot.connection);
+
+      transaction.exec("SELECT 1");
+
+      return;
+    } catch (const pqxx::failure&) {
+    }
+  }
+
+  reconnects_->add();
+
+  open(slot);
+}
+
+void DatabaseManager::open(Slot& slot) {
+  slot.connection.reset();
+  slot.connection = std::make_unique<pqxx::connection>(connection_string_);
+  slot.last_used = std::chrono::steady_clock::now();
+
+  // A statement failing to prepare only fails the requests executing it.
+  for (const auto* statement : statements()) {
+    try {
+      slot.connection->prepare(statement->name(), statement->query());
+    } catch (const pqxx::sql_error& error) {
+      spdlog::warn("Failed to prepare statement {}: {}", statement->name(), error.what());
+    }
+  }
+}
+
+void DatabaseManager::release(Pool& pool, Slot& slot) {
+  // A broken connection is reopened by whoever borrows the slot next.
+  if (slot.connection != nullptr && !slot.connection->is_open()) [[unlikely]] {
+    slot.connection.reset();
+  }
+
+  slot.last_used = std::chrono::steady_clock::now();
+
+  {
+    std::lock_guard lock(pool.mutex);
+
+    pool.idle_slots.push_back(&slot);
+  }
+
+  pool.available.notify_one();
+}
+
 }  // namespace detail
@@ -1,6 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include "metrics.hpp"
 
 namespace pqxx {
 
@@ -10,9 +17,83 @@ class connection;
 
 namespace detail {
 
+// Pools of database connections, sized independently of the threads using them. There is a pool
+// per worker pool, a worker borrows from its own, so one kind of work cannot take the
+// connections of another. Every registered statement is prepared on a connection once, when it
+// is opened, so executing a query does not have the server parse and plan it again.
 class DatabaseManager {
  public:
-  pqxx::connection& connection();
+  // Query prepared on every connection under name. Statements are defined at namespace scope,
+  // so all of them are registered before the first connection is opened.
+  class Statement {
+   public:
+    Statement(std::string name, std::string query);
+    Statement(const Statement&) = delete;
+
+    Statement& operator=(const Statement&) = delete;
+
+    [[nodiscard]] const std::string& name() const;
+
+    [[nodiscard]] const std::string& query() const;
+
+   private:
+    const std::string name_;
+    const std::string query_;
+  };
+
+ private:
+  struct Slot {
+    std::unique_ptr<pqxx::connection> connection;
+    std::chrono::steady_clock::time_point last_used;
+  };
+
+  struct Pool {
+    std::mutex mutex;
+    std::condition_variable available;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<Slot*> idle_slots;
+  };
+
+ public:
+  // Connection borrowed from a pool, returned to it when destroyed. A thread borrowing again
+  // while holding one gets the same connection, so helpers called from a request handler never
+  // wait for a second one.
+  class Connection {
+   public:
+    Connection(const Connection&) = delete;
+    Connection(Connection&& other) noexcept;
+    ~Connection();
+
+    Connection& operator=(const Connection&) = delete;
+    Connection& operator=(Connection&&) = delete;
+
+    pqxx::connection& operator*() const;
+
+    pqxx::connection* operator->() const;
+
+   private:
+    Connection(DatabaseManager& manager, Pool* pool, Slot* slot);
+
+   private:
+    DatabaseManager& manager_;
+    // Null when the connection is borrowed again by the thread holding it.
+    Pool* pool_;
+    Slot* slot_;
+
+   private:
+    friend DatabaseManager;
+  };
+
+ public:
+  DatabaseManager();
+  ~DatabaseManager();
+
+  // Opens the connections of every pool, must be called before a connection is borrowed.
+  void configure(const std::vector<size_t>& pool_sizes);
+
+  // Borrows a connection from the pool of the calling worker, waiting while all are in use. A
+  // connection found broken or failing its health check is reopened first.
+  [[nodiscard]] Connection connection();
 
   [[nodiscard]] const std::string& connection_string() const;
 
@@ -20,8 +101,23 @@ class DatabaseManager {
 
   void set_connection_string(std::string string);
 
+ private:
+  // Reopens the connection of the slot, if it is missing, broken or fails its health check.
+  void ensure_healthy(Slot& slot);
+
+  void open(Slot& slot);
+
+  void release(Pool& pool, Slot& slot);
+
  private:
   std::string connection_string_;
+
+  std::vector<std::unique_ptr<Pool>> pools_;
+  // The connection the calling thread holds, if any.
+  static thread_local Slot* borrowed_slot_;
+
+  metrics::Counter* reconnects_;
+  metrics::Histogram* wait_duration_;
 };
 
 }  // namespace detail
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "utils/debug/assert.hpp"
+
+namespace detail {
+
+// Items queued per flow, e.g. the requests of a client, and served across flows by deficit round
+// robin weighted by item size, so a flow of large items cannot starve the others. A flow hands out
+// one item at a time and is back in the round once that item is completed, so the items of a flow
+// are executed one after another, in the order they were pushed.
+template <typename T>
+class FairQueue {
+ public:
+  // A flow earns QUANTUM per visit and an item costs its size in bytes on top of ITEM_BASE_COST,
+  // which stands for the work every item does regardless of its size. Most items fit in a single
+  // quantum, a large one waits a few rounds.
+  static constexpr size_t QUANTUM = 4 * 1024;
+  static constexpr size_t ITEM_BASE_COST = 256;
+
+ public:
+  // Queues the item, returns true when its flow joined the round.
+  [[nodiscard]] bool push(uint64_t flow_id, T&& item, size_t size) {
+    auto& flow = flows_[flow_id];
+
+    const bool idle = flow.items.empty() && !flow.executing;
+
+    flow.items.emplace_back(std::move(item), ITEM_BASE_COST + size);
+
+    if (idle) {
+      active_flows_.push_back(flow_id);
+    }
+
+    return idle;
+  }
+
+  // Takes the next item of the round, which must not be empty. Its flow leaves the round until the
+  // item is completed.
+  [[nodiscard]] std::pair<uint64_t, T> pop() {
+    ASSERT(!active_flows_.empty());
+
+    // Terminates, every visit adds a quantum to a flow until its item fits.
+    while (true) {
+      const auto flow_id = active_flows_.front();
+
+      auto& flow = flows_.at(flow_id);
+      auto& [item, cost] = flow.items.front();
+
+      flow.deficit += QUANTUM;
+
+      if (flow.deficit >= cost) {
+        // A flow leaves the round after one item, so what is left is capped rather than carried
+        // over visit after visit by a flow of only small items.
+        flow.deficit = std::min(flow.deficit - cost, QUANTUM);
+        flow.executing = true;
+
+        std::pair<uint64_t, T> next(flow_id, std::move(item));
+
+        flow.items.pop_front();
+        active_flows_.pop_front();
+
+        return next;
+      }
+
+      active_flows_.splice(active_flows_.end(), active_flows_, active_flows_.begin());
+    }
+  }
+
+  // Completes the item of the flow taken last, returns true when the flow joined the round again.
+  [[nodiscard]] bool complete(uint64_t flow_id) {
+    auto flow = flows_.find(flow_id);
+
+    ASSERT(flow != flows_.end() && flow->second.executing);
+
+    flow->second.executing = false;
+
+    if (flow->second.items.empty()) {
+      flows_.erase(flow);
+
+      return false;
+    }
+
+    active_flows_.push_back(flow_id);
+
+    return true;
+  }
+
+ private:
+  struct Flow {
+    // Every item with its cost.
+    std::deque<std::pair<T, size_t>> items;
+    size_t deficit = 0;
+    bool executing = false;
+  };
+
+ private:
+  std::unordered_map<uint64_t, Flow> flows_;
+  std::list<uint64_t> active_flows_;
+};
+
+}  // namespace detail
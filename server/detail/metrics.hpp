@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace detail {
+
+namespace metrics {
+
+// Lock-free metric primitives, registered and exported by MetricsManager. Every update is a
+// single relaxed atomic operation, readers only need a consistent-enough view for scraping.
+
+class Counter {
+ public:
+  void add(uint64_t value = 1) { value_.fetch_add(value, std::memory_order_relaxed); }
+
+  // Raises the counter to value, for totals sampled elsewhere. A stale, smaller value is ignored.
+  void advance_to(uint64_t value) {
+    for (auto current = value_.load(std::memory_order_relaxed);
+         current < value &&
+         !value_.compare_exchange_weak(current, value, std::memory_order_relaxed);) {
+    }
+  }
+
+  [[nodiscard]] uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  alignas(64) std::atomic<uint64_t> value_ = 0;
+};
+
+class Gauge {
+ public:
+  void add(int64_t value = 1) { value_.fetch_add(value, std::memory_order_relaxed); }
+
+  void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+
+  void sub(int64_t value = 1) { value_.fetch_sub(value, std::memory_order_relaxed); }
+
+  [[nodiscard]] int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  alignas(64) std::atomic<int64_t> value_ = 0;
+};
+
+// Log-linear histogram in the spirit of HdrHistogram: every power of two is split into
+// SUB_BUCKETS linear buckets, so any recorded value is known within 1 / SUB_BUCKETS of its
+// magnitude, from 0 up to 2^64, in a fixed 4 KiB array.
+class Histogram {
+ public:
+  static constexpr size_t SUB_BUCKET_BITS = 3;
+  static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+  static constexpr size_t BUCKETS = SUB_BUCKETS * (65 - SUB_BUCKET_BITS);
+
+  // Records the time elapsed since construction in microseconds.
+  class Timer {
+   public:
+    explicit Timer(Histogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+
+    Timer(const Timer&) = delete;
+
+    ~Timer() {
+      histogram_.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start_)
+                            .count());
+    }
+
+   private:
+    Histogram& histogram_;
+    const std::chrono::steady_clock::time_point start_;
+  };
+
+ public:
+  [[nodiscard]] static size_t bucket(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+      return value;
+    }
+
+    const size_t exponent = std::bit_width(value) - 1;
+    const size_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+
+    return SUB_BUCKETS * (exponent - SUB_BUCKET_BITS + 1) + sub_bucket;
+  }
+
+  // Smallest value that falls into a bucket past the given one.
+  [[nodiscard]] static uint64_t bucket_end(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+      return bucket + 1;
+    }
+
+    const size_t exponent = bucket / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    const uint64_t sub_bucket = bucket % SUB_BUCKETS;
+
+    return (SUB_BUCKETS + sub_bucket + 1) << (exponent - SUB_BUCKET_BITS);
+  }
+
+ public:
+  void record(uint64_t value) {
+    buckets_[bucket(value)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] Timer time() { return Timer(*this); }
+
+  [[nodiscard]] uint64_t count(size_t bucket) const {
+    return buckets_[bucket].load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+
+ private:
+  std::array<std::atomic<uint64_t>, BUCKETS> buckets_{};
+  std::atomic<uint64_t> sum_ = 0;
+};
+
+}  // namespace metrics
+
+}  // namespace detail
@@ -0,0 +1,328 @@
+#include "metrics_manager.hpp"
+
+#include <fmt/format.h>
+
+#include <asio/post.hpp>
+#include <asio/read_until.hpp>
+#include <asio/write.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <type_traits>
+
+#include "utils/debug/assert.hpp"
+
+namespace detail {
+
+namespace {
+
+constexpr auto PROBE_INTERVAL = std::chrono::seconds(1);
+
+// Exported histogram buckets are the powers of two from 2^0 up to 2^25 units (~33.5 s when the
+// unit is a microsecond), which coincide with internal bucket boundaries. Recorded values are
+// truncated, so everything below a bound was at most the bound before truncation.
+constexpr size_t EXPORTED_BUCKETS = 26;
+
+constexpr size_t MAX_REQUEST_SIZE = 8 * 1024;
+
+template <typename T>
+constexpr size_t TYPE_INDEX = std::is_same_v<T, metrics::Counter> ? 0
+                              : std::is_same_v<T, metrics::Gauge> ? 1
+                                                                  : 2;
+
+constexpr std::string_view TYPE_NAMES[] = {"counter", "gauge", "histogram"};
+
+std::string render(MetricsManager::Labels labels) {
+  std::string result;
+
+  for (const auto& [name, value] : labels) {
+    if (!result.empty()) {
+      result += ',';
+    }
+
+    result += name;
+    result += "=\"";
+
+    for (auto character : value) {
+      switch (character) {
+        case '\\':
+          result += "\\\\";
+          break;
+        case '"':
+          result += "\\\"";
+          break;
+        case '\n':
+          result += "\\n";
+          break;
+        default:
+          result += character;
+          break;
+      }
+    }
+
+    result += '"';
+  }
+
+  return result;
+}
+
+// Joins the series labels with an extra one, e.g. the "le" label of a histogram bucket.
+std::string join(const std::string& labels, std::string_view extra) {
+  if (labels.empty() && extra.empty()) {
+    return {};
+  }
+
+  if (labels.empty()) {
+    return fmt::format("{{{}}}", extra);
+  }
+
+  if (extra.empty()) {
+    return fmt::format("{{{}}}", labels);
+  }
+
+  return fmt::format("{{{},{}}}", labels, extra);
+}
+
+struct Session {
+  explicit Session(asio::generic::stream_protocol::socket&& socket) : socket(std::move(socket)) {}
+
+  asio::generic::stream_protocol::socket socket;
+  std::string request;
+  std::string response;
+};
+
+}  // namespace
+
+MetricsManager::MetricsManager(asio::io_context& io_context)
+    : io_context_(io_context) {}
+
+MetricsManager::~MetricsManager() = default;
+
+void MetricsManager::add_collector(std::function<void()> collector) {
+  std::unique_lock lock(mutex_);
+
+  collectors_.push_back(std::move(collector));
+}
+
+metrics::Counter& MetricsManager::counter(std::string_view name, std::string_view help,
+                                          Labels labels) {
+  return find_or_create<metrics::Counter>(name, help, 1.0, labels);
+}
+
+metrics::Gauge& MetricsManager::gauge(std::string_view name, std::string_view help,
+                                      Labels labels) {
+  return find_or_create<metrics::Gauge>(name, help, 1.0, labels);
+}
+
+metrics::Histogram& MetricsManager::histogram(std::string_view name, std::string_view help,
+                                              double scale, Labels labels) {
+  return find_or_create<metrics::Histogram>(name, help, scale, labels);
+}
+
+std::string MetricsManager::serialize() const {
+  std::vector<std::function<void()>> collectors;
+
+  {
+    std::shared_lock lock(mutex_);
+
+    collectors = collectors_;
+  }
+
+  for (const auto& collector : collectors) {
+    collector();
+  }
+
+  std::shared_lock lock(mutex_);
+
+  std::string result;
+
+  for (const auto& [name, family] : families_) {
+    fmt::format_to(std::back_inserter(result), "# HELP {} {}\n# TYPE {} {}\n", name, family.help,
+                   name, TYPE_NAMES[family.type]);
+
+    for (const auto& [labels, metric] : family.metrics) {
+      if (const auto* counter = std::get_if<metrics::Counter>(metric.get())) {
+        fmt::format_to(std::back_inserter(result), "{}{} {}\n", name, join(labels, {}),
+                       counter->value());
+      } else if (const auto* gauge = std::get_if<metrics::Gauge>(metric.get())) {
+        fmt::format_to(std::back_inserter(result), "{}{} {}\n", name, join(labels, {}),
+                       gauge->value());
+      } else {
+        const auto& histogram = std::get<metrics::Histogram>(*metric);
+
+        uint64_t count = 0;
+        size_t bucket = 0;
+
+        for (size_t exported = 0; exported < EXPORTED_BUCKETS; ++exported) {
+          const uint64_t bound = uint64_t(1) << exported;
+
+          for (; metrics::Histogram::bucket_end(bucket) <= bound; ++bucket) {
+            count += histogram.count(bucket);
+          }
+
+          fmt::format_to(std::back_inserter(result), "{}_bucket{} {}\n", name,
+                         join(labels, fmt::format("le=\"{}\"", bound * family.scale)), count);
+        }
+
+        for (; bucket < metrics::Histogram::BUCKETS; ++bucket) {
+          count += histogram.count(bucket);
+        }
+
+        fmt::format_to(std::back_inserter(result), "{}_bucket{} {}\n{}_sum{} {}\n{}_count{} {}\n",
+                       name, join(labels, "le=\"+Inf\""), count, name, join(labels, {}),
+                       histogram.sum() * family.scale, name, join(labels, {}), count);
+      }
+    }
+  }
+
+  return result;
+}
+
+void MetricsManager::start(Configuration&& configuration,
+                           std::vector<std::reference_wrapper<asio::io_context>> io_contexts) {
+  ASSERT(!acceptor_.has_value());
+
+  probed_io_contexts_ = std::move(io_contexts);
+
+  acceptor_.emplace(io_context_, configuration.endpoint.protocol());
+
+  if (configuration.endpoint.protocol().family() != AF_UNIX) {
+    acceptor_->set_option(asio::socket_base::reuse_address(true));
+  }
+
+  acceptor_->bind(configuration.endpoint);
+  acceptor_->listen();
+
+  async_accept();
+
+  probe_timer_.emplace(io_context_);
+
+  async_wait_probe_timer();
+}
+
+void MetricsManager::stop() {
+  if (acceptor_.has_value()) {
+    acceptor_->close();
+    acceptor_.reset();
+  }
+
+  if (probe_timer_.has_value()) {
+    probe_timer_->cancel();
+    probe_timer_.reset();
+  }
+}
+
+template <typename T>
+T& MetricsManager::find_or_create(std::string_view name, std::string_view help, double scale,
+                                  Labels labels) {
+  auto key = render(labels);
+
+  {
+    std::shared_lock lock(mutex_);
+
+    if (auto family = families_.find(name); family != families_.end()) [[likely]] {
+      if (auto metric = family->second.metrics.find(key); metric != family->second.metrics.end())
+          [[likely]] {
+        if (auto* result = std::get_if<T>(metric->second.get())) [[likely]] {
+          return *result;
+        }
+      }
+    }
+  }
+
+  std::unique_lock lock(mutex_);
+
+  auto family = families_.find(name);
+
+  if (family == families_.end()) {
+    family = families_
+                 .emplace(std::string(name),
+                          Family{std::string(help), scale, TYPE_INDEX<T>, {}})
+                 .first;
+  }
+
+  if (family->second.type != TYPE_INDEX<T>) [[unlikely]] {
+    throw std::runtime_error(fmt::format("Metric {} registered with another type", name));
+  }
+
+  auto& metric = family->second.metrics[std::move(key)];
+
+  if (metric == nullptr) {
+    metric = std::make_unique<Metric>(std::in_place_type<T>);
+  }
+
+  return std::get<T>(*metric);
+}
+
+void MetricsManager::async_accept() {
+  acceptor_->async_accept([this](const asio::error_code& error,
+                                 asio::generic::stream_protocol::socket socket) {
+    if (error == asio::error::operation_aborted) {
+      return;
+    }
+
+    if (!error) [[likely]] {
+      auto session = std::make_shared<Session>(std::move(socket));
+
+      // Any request is answered with the metrics, there is nothing else to serve.
+      asio::async_read_until(
+          session->socket, asio::dynamic_buffer(session->request, MAX_REQUEST_SIZE), "\r\n\r\n",
+          [this, session](const asio::error_code& error, size_t) {
+            if (error) {
+              return;
+            }
+
+            auto body = serialize();
+
+            session->response = fmt::format(
+                "HTTP/1.0 200 OK\r\n"
+                "Content-Type: text/plain; version=0.0.4\r\n"
+                "Content-Length: {}\r\n"
+                "Connection: close\r\n"
+                "\r\n"
+                "{}",
+                body.size(), body);
+
+            asio::async_write(session->socket, asio::buffer(session->response),
+                              [session](const asio::error_code&, size_t) {
+                                asio::error_code ignored;
+                                session->socket.shutdown(asio::socket_base::shutdown_both, ignored);
+                              });
+          });
+    }
+
+    if (acceptor_.has_value()) {
+      async_accept();
+    }
+  });
+}
+
+// asio does not expose the length of the io_context queue, so it is measured by its effect
+// instead: once per interval a probe is posted to every io_context, and the delay until it runs
+// is recorded per io_context.
+void MetricsManager::async_wait_probe_timer() {
+  probe_timer_->expires_after(PROBE_INTERVAL);
+  probe_timer_->async_wait([this](const asio::error_code& error) {
+    if (error) {
+      return;
+    }
+
+    const auto posted = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < probed_io_contexts_.size(); ++i) {
+      asio::post(probed_io_contexts_[i].get(), [this, posted, i]() {
+        histogram("neutron_io_context_lag_seconds",
+                  "Delay between posting a handler to the io_context and running it", 1e-6,
+                  {{"io_context", std::to_string(i)}})
+            .record(std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - posted)
+                        .count());
+      });
+    }
+
+    if (probe_timer_.has_value()) {
+      async_wait_probe_timer();
+    }
+  });
+}
+
+}  // namespace detail
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <asio/basic_socket_acceptor.hpp>
+#include <asio/generic/stream_protocol.hpp>
+#include <asio/io_context.hpp>
+#include <asio/steady_timer.hpp>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "metrics.hpp"
+
+namespace detail {
+
+// Registry of the server metrics, exported in the Prometheus text format on a local TCP or UNIX
+// socket. Metrics are looked up by name and labels; the lookup takes a shared lock, updating the
+// returned metric does not, so hot paths keep the reference around.
+class MetricsManager {
+ public:
+  using Labels = std::initializer_list<std::pair<std::string_view, std::string_view>>;
+
+  struct Configuration {
+    asio::generic::stream_protocol::endpoint endpoint;
+  };
+
+ public:
+  explicit MetricsManager(asio::io_context& io_context);
+  ~MetricsManager();
+
+  // Runs before every scrape, e.g. to refresh gauges that are cheaper to sample than to track.
+  void add_collector(std::function<void()> collector);
+
+  metrics::Counter& counter(std::string_view name, std::string_view help, Labels labels = {});
+
+  metrics::Gauge& gauge(std::string_view name, std::string_view help, Labels labels = {});
+
+  // Values are recorded in unit and exported multiplied by scale, e.g. microseconds exported as
+  // seconds with a scale of 1e-6.
+  metrics::Histogram& histogram(std::string_view name, std::string_view help, double scale,
+                                Labels labels = {});
+
+  [[nodiscard]] std::string serialize() const;
+
+  // Scheduling lag is probed on every one of the given io_contexts.
+  void start(Configuration&& configuration,
+             std::vector<std::reference_wrapper<asio::io_context>> io_contexts);
+
+  void stop();
+
+ private:
+  using Metric = std::variant<metrics::Counter, metrics::Gauge, metrics::Histogram>;
+
+  struct Family {
+    std::string help;
+    double scale;
+    size_t type;  // index into Metric
+    std::map<std::string, std::unique_ptr<Metric>> metrics;
+  };
+
+ private:
+  template <typename T>
+  T& find_or_create(std::string_view name, std::string_view help, double scale, Labels labels);
+
+  void async_accept();
+
+  void async_wait_probe_timer();
+
+ private:
+  asio::io_context& io_context_;
+
+  mutable std::shared_mutex mutex_;
+  std::map<std::string, Family, std::less<>> families_;
+  std::vector<std::function<void()>> collectors_;
+
+  std::optional<asio::basic_socket_acceptor<asio::generic::stream_protocol>> acceptor_;
+  std::vector<std::reference_wrapper<asio::io_context>> probed_io_contexts_;
+  std::optional<asio::steady_timer> probe_timer_;
+};
+
+}  // namespace detail
@@ -13,6 +13,8 @@ void NetworkManager::start_accept(protocol::Server::Configuration &&configuratio
 
   new_connection_subscription_ =
       server_.new_connection()->subscribe([]() { new_connection_handler(); });
+
+  ServerImpl::instance().metrics_manager.add_collector([this]() { collect_statistics(); });
   server_.open(std::move(configuration));
 
   accepting_ = true;
@@ -33,11 +35,40 @@ void NetworkManager::new_connection_handler() {
     return;
   }
 
+  static auto& accepted = impl.metrics_manager.counter("neutron_connections_accepted_total",
+                                                       "Connections accepted by the transport");
+  static auto& handshake_duration = impl.metrics_manager.histogram(
+      "neutron_handshake_duration_seconds", "Transport handshake duration", 1e-6);
+
   while (impl.network_manager.server_.has_pending_connections()) {
     auto connection = impl.network_manager.server_.next_pending_connection();
 
+    accepted.add();
+    handshake_duration.record(static_cast<uint64_t>(connection->statistics().handshake_time * 1e3));
+
     impl.client_manager.add_unauthorized(std::move(connection));
   }
 }
 
+void NetworkManager::collect_statistics() const {
+  auto& metrics_manager = ServerImpl::instance().metrics_manager;
+
+  const auto statistics = server_.statistics();
+
+  metrics_manager
+      .gauge("neutron_transport_connections", "Connections tracked by the transport")
+      .set(statistics.connections);
+  metrics_manager
+      .gauge("neutron_transport_handshakes_rejected",
+             "Handshakes rejected by the transport since start", {{"reason", "dropped"}})
+      .set(statistics.dropped_handshakes);
+  metrics_manager
+      .gauge("neutron_transport_handshakes_rejected",
+             "Handshakes rejected by the transport since start", {{"reason", "rate_limit"}})
+      .set(statistics.limited_handshakes);
+  metrics_manager
+      .counter("neutron_transport_retransmissions_total", "Chunks retransmitted by the transport")
+      .advance_to(statistics.transport.retransmissions + statistics.transport.fast_retransmissions);
+}
+
 }  // namespace detail
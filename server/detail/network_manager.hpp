@@ -17,6 +17,8 @@ class NetworkManager {
  private:
   static void new_connection_handler();
 
+  void collect_statistics() const;
+
  private:
   bool accepting_;
   protocol::Server server_;
@@ -15,97 +15,226 @@
 #include <api/user/request/sign_in.pb.h>
 #include <api/user/request/sign_up.pb.h>
 #include <api/user/request/upload_one_time_key.pb.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <vector>
 
 #include "client.hpp"
-#include "utils/span/from.hpp"
+#include "server_impl.hpp"
 
 namespace detail {
 
+namespace {
+
+constexpr size_t ARENA_INITIAL_BLOCK_SIZE = 4 * 1024;
+
+// api::Request, api::chat::Request and api::user::Request all wrap a type and a serialized inner
+// request. They are decoded in place, data is a view into the received payload, so only the
+// innermost request is parsed, straight from the bytes it arrived in.
+struct Envelope {
+  int type = 0;
+  std::span<const uint8_t> data;
+};
+
+template <typename T>
+std::optional<Envelope> decode(std::span<const uint8_t> data) {
+  using google::protobuf::internal::WireFormatLite;
+
+  google::protobuf::io::CodedInputStream input(data.data(), static_cast<int>(data.size()));
+
+  Envelope envelope;
+
+  while (const auto tag = input.ReadTag()) {
+    const auto field_number = WireFormatLite::GetTagFieldNumber(tag);
+    const auto wire_type = WireFormatLite::GetTagWireType(tag);
+
+    if (field_number == T::kTypeFieldNumber && wire_type == WireFormatLite::WIRETYPE_VARINT) {
+      uint32_t type;
+
+      if (!input.ReadVarint32(&type)) {
+        return std::nullopt;
+      }
+
+      envelope.type = static_cast<int>(type);
+    } else if (field_number == T::kDataFieldNumber &&
+               wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32_t size;
+
+      if (!input.ReadVarint32(&size) ||
+          size > data.size() - static_cast<size_t>(input.CurrentPosition())) {
+        return std::nullopt;
+      }
+
+      envelope.data = data.subspan(input.CurrentPosition(), size);
+
+      input.Skip(static_cast<int>(size));
+    } else if (!WireFormatLite::SkipField(&input, tag)) {
+      return std::nullopt;
+    }
+  }
+
+  if (!input.ConsumedEntireMessage()) {
+    return std::nullopt;
+  }
+
+  return envelope;
+}
+
+template <typename T>
+const T* parse(google::protobuf::Arena& arena, std::span<const uint8_t> data) {
+  auto* message = google::protobuf::Arena::CreateMessage<T>(&arena);
+
+  if (!message->ParseFromArray(data.data(), static_cast<int>(data.size()))) {
+    return nullptr;
+  }
+
+  return message;
+}
+
+// Counters of every request type of a group, indexed by type. Resolved once, so counting a
+// request neither renders labels nor takes the registry lock.
+std::vector<metrics::Counter*> request_counters(std::string_view group,
+                                                const google::protobuf::EnumDescriptor& types) {
+  auto& metrics_manager = ServerImpl::instance().metrics_manager;
+
+  std::vector<metrics::Counter*> counters;
+
+  for (int i = 0; i < types.value_count(); ++i) {
+    const auto& type = *types.value(i);
+
+    if (type.number() < 0) [[unlikely]] {
+      continue;
+    }
+
+    if (counters.size() <= static_cast<size_t>(type.number())) {
+      counters.resize(type.number() + 1, nullptr);
+    }
+
+    counters[type.number()] = &metrics_manager.counter(
+        "neutron_requests_total", "Requests received, by type",
+        {{"group", group}, {"type", type.name()}});
+  }
+
+  return counters;
+}
+
+void count_request(const std::vector<metrics::Counter*>& counters, int type) {
+  if (type >= 0 && static_cast<size_t>(type) < counters.size() && counters[type] != nullptr)
+      [[likely]] {
+    counters[type]->add();
+  }
+}
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client, const api::chat::Request& request) {
+RequestHandler::Response RequestHandler::dispatch<api::chat::Request>(
+    const Client& client, std::span<const uint8_t> data, google::protobuf::Arena& arena) {
+  auto envelope = decode<api::chat::Request>(data);
+
+  if (!envelope.has_value()) {
+    throw InvalidDataException();
+  }
+
+  static const auto counters = request_counters("chat", *api::chat::Request_Type_descriptor());
+
+  count_request(counters, envelope->type);
+
   (void)client;
-  (void)request;
+  (void)arena;
 
   throw InvalidDataException();
 }
 
 template <>
-std::string RequestHandler::handle(const Client& client, const api::user::Request& request) {
-  switch (request.type()) {
+RequestHandler::Response RequestHandler::dispatch<api::user::Request>(
+    const Client& client, std::span<const uint8_t> data, google::protobuf::Arena& arena) {
+  auto envelope = decode<api::user::Request>(data);
+
+  if (!envelope.has_value()) {
+    throw InvalidDataException();
+  }
+
+  static const auto counters = request_counters("user", *api::user::Request_Type_descriptor());
+
+  count_request(counters, envelope->type);
+
+  switch (envelope->type) {
     case api::user::Request_Type_CREATE_CONNECTION: {
-      api::user::request::CreateConnection inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
+      if (auto* inner_request =
+              parse<api::user::request::CreateConnection>(arena, envelope->data)) {
+        return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_DELETE_CONNECTION: {
-      api::user::request::DeleteConnection inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
+      if (auto* inner_request =
+              parse<api::user::request::DeleteConnection>(arena, envelope->data)) {
+        return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_EDIT_PASSWORD: {
-      api::user::request::EditPassword inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        // return handle(client, inner_request);
+      if ([[maybe_unused]] auto* inner_request =
+              parse<api::user::request::EditPassword>(arena, envelope->data)) {
+        // return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_EDIT_PHOTO: {
-      api::user::request::EditPhoto inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        // return handle(client, inner_request);
+      if ([[maybe_unused]] auto* inner_request =
+              parse<api::user::request::EditPhoto>(arena, envelope->data)) {
+        // return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_GET_CONNECTIONS: {
-      api::user::request::GetConnections inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
+      if (auto* inner_request = parse<api::user::request::GetConnections>(arena, envelope->data)) {
+        return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_GET_INFO: {
-      api::user::request::GetInfo inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        // return handle(client, inner_request);
+      if ([[maybe_unused]] auto* inner_request =
+              parse<api::user::request::GetInfo>(arena, envelope->data)) {
+        // return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_LOGOUT: {
-      api::user::request::Logout inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
+      if (auto* inner_request = parse<api::user::request::Logout>(arena, envelope->data)) {
+        return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_REVOKE_DEVICE: {
-      api::user::request::RevokeDevice inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
+      if (auto* inner_request = parse<api::user::request::RevokeDevice>(arena, envelope->data)) {
+        return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_SIGN_IN: {
-      api::user::request::SignIn inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
+      if (auto* inner_request = parse<api::user::request::SignIn>(arena, envelope->data)) {
+        return handle(client, *inner_request);
       }
       break;
     }
     case api::user::Request_Type_SIGN_UP: {
-      api::user::request::SignUp inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(inner_request);
+      if (auto* inner_request = parse<api::user::request::SignUp>(arena, envelope->data)) {
+        return handle(*inner_request);
       }
       break;
     }
     case api::user::Request_Type_UPLOAD_ONE_TIME_KEY: {
-      api::user::request::UploadOneTimeKey inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
+      if (auto* inner_request =
+              parse<api::user::request::UploadOneTimeKey>(arena, envelope->data)) {
+        return handle(client, *inner_request);
       }
       break;
     }
@@ -118,22 +247,20 @@ std::string RequestHandler::handle(const Client& client, const api::user::Reques
 }
 
 template <>
-std::string RequestHandler::handle(const Client& client, const api::Request& request) {
-  switch (request.type()) {
-    case api::Request_Type_CHAT: {
-      api::chat::Request inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
-      }
-      break;
-    }
-    case api::Request_Type_USER: {
-      api::user::Request inner_request;
-      if (inner_request.ParseFromString(request.data())) {
-        return handle(client, inner_request);
-      }
-      break;
-    }
+RequestHandler::Response RequestHandler::dispatch<api::Request>(const Client& client,
+                                                               std::span<const uint8_t> data,
+                                                               google::protobuf::Arena& arena) {
+  auto envelope = decode<api::Request>(data);
+
+  if (!envelope.has_value()) {
+    throw InvalidDataException();
+  }
+
+  switch (envelope->type) {
+    case api::Request_Type_CHAT:
+      return dispatch<api::chat::Request>(client, envelope->data, arena);
+    case api::Request_Type_USER:
+      return dispatch<api::user::Request>(client, envelope->data, arena);
     case api::Request_Type_Request_Type_INT_MAX_SENTINEL_DO_NOT_USE_:
     case api::Request_Type_Request_Type_INT_MIN_SENTINEL_DO_NOT_USE_:
       break;
@@ -143,16 +270,76 @@ std::string RequestHandler::handle(const Client& client, const api::Request& req
 }
 
 void RequestHandler::handle(Client& client, size_t request_identifier,
-                            const api::Request& request) {
-  try {
-    auto response_data = handle(client, request);
+                            std::span<const uint8_t> data) {
+  auto& metrics_manager = ServerImpl::instance().metrics_manager;
+
+  static auto& duration = metrics_manager.histogram(
+      "neutron_request_duration_seconds", "Time to handle a request and queue its response", 1e-6);
+  static auto& failures = metrics_manager.counter(
+      "neutron_request_failures_total", "Requests answered with an exception");
+
+  const auto timer = duration.time();
 
-    client.communication().send_response(request_identifier,
-                                         utils::span::from<const uint8_t>(response_data));
+  // Requests are small, so the arena rarely has to allocate beyond its initial block.
+  alignas(std::max_align_t) std::array<char, ARENA_INITIAL_BLOCK_SIZE> initial_block;
+
+  google::protobuf::ArenaOptions arena_options;
+  arena_options.initial_block = initial_block.data();
+  arena_options.initial_block_size = initial_block.size();
+
+  google::protobuf::Arena arena(arena_options);
+
+  Response response;
+
+  try {
+    response = dispatch<api::Request>(client, data, arena);
   } catch (...) {
-    client.communication().send_exception(request_identifier,
-                                          api::ExceptionCode::INTERNAL_SERVER_ERROR);
+    failures.add();
+
+    client.communication().try_send_exception(request_identifier,
+                                              api::ExceptionCode::INTERNAL_SERVER_ERROR);
+
+    return;
+  }
+
+  // The client may go away while the request is executed, then there is no one to answer to.
+  client.communication().try_send_response(request_identifier, std::move(response));
+}
+
+std::optional<std::pair<int, int>> RequestHandler::peek_type(std::span<const uint8_t> data) {
+  auto envelope = decode<api::Request>(data);
+
+  if (!envelope.has_value()) {
+    return std::nullopt;
+  }
+
+  std::optional<Envelope> inner_envelope;
+
+  switch (envelope->type) {
+    case api::Request_Type_CHAT:
+      inner_envelope = decode<api::chat::Request>(envelope->data);
+      break;
+    case api::Request_Type_USER:
+      inner_envelope = decode<api::user::Request>(envelope->data);
+      break;
+    case api::Request_Type_Request_Type_INT_MAX_SENTINEL_DO_NOT_USE_:
+    case api::Request_Type_Request_Type_INT_MIN_SENTINEL_DO_NOT_USE_:
+      break;
+  }
+
+  if (!inner_envelope.has_value()) {
+    return std::nullopt;
   }
+
+  return std::make_pair(envelope->type, inner_envelope->type);
+}
+
+RequestHandler::Response RequestHandler::serialize(const google::protobuf::MessageLite& message) {
+  auto response = communication::Server::build_response(message.ByteSizeLong());
+
+  message.SerializeWithCachedSizesToArray(response.data().data());
+
+  return response;
 }
 
 }  // namespace detail
@@ -1,13 +1,21 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
+#include <span>
 #include <string>
+#include <utility>
 
-namespace api {
+#include "communication/server.hpp"
 
-class Request;
+namespace google {
+namespace protobuf {
 
-}
+class Arena;
+class MessageLite;
+
+}  // namespace protobuf
+}  // namespace google
 
 namespace detail {
 
@@ -15,7 +23,12 @@ class Client;
 
 class RequestHandler {
  public:
-  void handle(Client& client, size_t request_identifier, const api::Request& request);
+  // data is a serialized api::Request.
+  void handle(Client& client, size_t request_identifier, std::span<const uint8_t> data);
+
+  // Type of the api::Request in data and type of the request it wraps, read without parsing
+  // either. Empty when data is malformed.
+  static std::optional<std::pair<int, int>> peek_type(std::span<const uint8_t> data);
 
  private:
   struct InternalServerError : std::exception {
@@ -35,13 +48,23 @@ class RequestHandler {
   };
 
  private:
+  using Response = communication::Server::ResponseBuffer;
+
   struct Helpers;
 
+  // Decodes the T envelope in data and hands what it wraps on, parsed on arena.
   template <typename T>
-  std::string handle(const T&);
+  Response dispatch(const Client& client, std::span<const uint8_t> data,
+                    google::protobuf::Arena& arena);
 
   template <typename T>
-  std::string handle(const Client& client, const T&);
+  Response handle(const T&);
+
+  template <typename T>
+  Response handle(const Client& client, const T&);
+
+  // Serializes message straight into the response message.
+  static Response serialize(const google::protobuf::MessageLite& message);
 };
 
 }  // namespace detail
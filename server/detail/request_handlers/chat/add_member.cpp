@@ -10,13 +10,12 @@
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
 #include "server_impl.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::chat::request::AddMember& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::chat::request::AddMember& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
@@ -30,7 +29,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::AddMember_Error_Code_CHAT_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
   if (!Helpers::User::does_user_exist(request.user_id())) {
     api::chat::response::AddMember response;
@@ -39,7 +38,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::AddMember_Error_Code_USER_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   auto members_user_ids = Helpers::Chat::get_chat_members(request.chat_id());
@@ -52,7 +51,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::AddMember_Error_Code_YOU_ARE_NOT_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (!Helpers::Chat::is_chat_owner(request.chat_id(), client.user_id())) {
@@ -62,7 +61,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::AddMember_Error_Code_INSUFFICIENT_RIGHTS);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
   if (Helpers::Chat::is_deleted(request.chat_id())) {
     api::chat::response::AddMember response;
@@ -71,7 +70,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::AddMember_Error_Code_CHAT_IS_DELETED);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (std::find(members_user_ids.begin(), members_user_ids.end(), request.user_id()) !=
@@ -82,7 +81,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::AddMember_Error_Code_USER_IS_ALREADY_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (!Helpers::User::is_connection_established(client.user_id(), request.user_id())) {
@@ -92,7 +91,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::AddMember_Error_Code_CONNECTION_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   {
@@ -111,21 +110,14 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_CHAT, chat_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    for (const auto& user_id : members_user_ids) {
-      impl.client_manager.do_for_each(user_id, do_notify);
-    }
+    impl.client_manager.broadcast(members_user_ids, Helpers::frame_event(event));
   }
 
   Helpers::Chat::rotate_keys(request.chat_id(), members_user_ids);
 
   api::chat::response::AddMember response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }  // namespace detail
 
 }  // namespace detail
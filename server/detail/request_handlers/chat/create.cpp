@@ -11,29 +11,34 @@
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
 #include "server_impl.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement INSERT_CHAT("chat_create_insert_chat",
+                                            "INSERT INTO chats "
+                                            "RETURNING id");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::chat::request::Create& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::chat::request::Create& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   uint64_t chat_id;
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    auto result = transaction.exec_params1(
-        "INSERT INTO chats "
-        "RETURNING id");
+    auto result = transaction.exec_prepared1(INSERT_CHAT.name());
 
     transaction.commit();
 
@@ -54,12 +59,7 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_CHAT, chat_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    impl.client_manager.do_for_each(client.user_id(), do_notify);
+    impl.client_manager.broadcast({client.user_id()}, Helpers::frame_event(event));
   }
 
   api::chat::response::Create response;
@@ -68,7 +68,7 @@ std::string RequestHandler::handle(const Client& client,
 
   response_result->set_id(chat_id);
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
@@ -11,20 +11,29 @@
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
 #include "server_impl.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement UPDATE_CHAT_DELETED(
+    "chat_delete_mark_deleted",
+    "UPDATE chats "
+    "SET deleted = true "
+    "WHERE id = $1");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::chat::request::Delete& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::chat::request::Delete& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   if (!Helpers::Chat::does_chat_exist(request.id())) {
     api::chat::response::Delete response;
@@ -33,7 +42,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::Delete_Error_Code_CHAT_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   auto members_user_ids = Helpers::Chat::get_chat_members(request.id());
@@ -46,7 +55,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::Delete_Error_Code_YOU_ARE_NOT_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (!Helpers::Chat::is_chat_owner(request.id(), client.user_id())) {
@@ -56,7 +65,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::Delete_Error_Code_INSUFFICIENT_RIGHTS);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
   if (Helpers::Chat::is_deleted(request.id())) {
     api::chat::response::Delete response;
@@ -65,17 +74,13 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::Delete_Error_Code_CHAT_IS_ALREADY_DELETED);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params(
-        "UPDATE chats "
-        "SET deleted = true "
-        "WHERE id = $1",
-        request.id());
+    transaction.exec_prepared(UPDATE_CHAT_DELETED.name(), request.id());
 
     transaction.commit();
   }
@@ -88,19 +93,12 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_CHAT, chat_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    for (const auto& user_id : members_user_ids) {
-      impl.client_manager.do_for_each(user_id, do_notify);
-    }
+    impl.client_manager.broadcast(members_user_ids, Helpers::frame_event(event));
   }
 
   api::chat::response::Delete response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
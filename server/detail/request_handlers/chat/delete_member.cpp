@@ -10,20 +10,27 @@
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
 #include "server_impl.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement DELETE_CHAT_MEMBER(
+    "chat_delete_member_delete_member",
+    "DELETE FROM chats_members WHERE chat_id = $1 AND user_id = $2");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::chat::request::DeleteMember& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::chat::request::DeleteMember& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   if (!Helpers::Chat::does_chat_exist(request.chat_id())) {
     api::chat::response::DeleteMember response;
@@ -32,7 +39,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::DeleteMember_Error_Code_CHAT_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   auto members_user_ids = Helpers::Chat::get_chat_members(request.chat_id());
@@ -45,7 +52,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::DeleteMember_Error_Code_YOU_ARE_NOT_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (!Helpers::Chat::is_chat_owner(request.chat_id(), client.user_id())) {
@@ -55,7 +62,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::DeleteMember_Error_Code_INSUFFICIENT_RIGHTS);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
   if (Helpers::Chat::is_deleted(request.chat_id())) {
     api::chat::response::DeleteMember response;
@@ -64,7 +71,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::DeleteMember_Error_Code_CHAT_IS_DELETED);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (std::find(members_user_ids.begin(), members_user_ids.end(), request.user_id()) ==
@@ -75,20 +82,17 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::DeleteMember_Error_Code_USER_IS_NOT_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params("DELETE FROM chats_members WHERE chat_id = $1 AND user_id = $2",
-                            request.chat_id(), request.user_id());
+    transaction.exec_prepared(DELETE_CHAT_MEMBER.name(), request.chat_id(), request.user_id());
 
     transaction.commit();
   }
 
-  std::erase(members_user_ids, request.user_id());
-
   {
     api::chat::event::MemberDeleted inner_chat_event;
 
@@ -100,22 +104,17 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_CHAT, chat_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    for (const auto& user_id : members_user_ids) {
-      impl.client_manager.do_for_each(user_id, do_notify);
-    }
-    impl.client_manager.do_for_each(request.user_id(), do_notify);
+    // The deleted member is notified as well.
+    impl.client_manager.broadcast(members_user_ids, Helpers::frame_event(event));
   }
 
+  std::erase(members_user_ids, request.user_id());
+
   Helpers::Chat::rotate_keys(request.chat_id(), members_user_ids);
 
   api::chat::response::DeleteMember response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
@@ -1,8 +1,8 @@
 #include <api/chat/request/get_chats.pb.h>
 #include <api/chat/response/get_chats.pb.h>
-#include <fmt/core.h>
-
+#include <optional>
 #include <pqxx/pqxx>
+#include <utility>
 
 #include "../../client.hpp"
 #include "../../request_handler.hpp"
@@ -11,48 +11,46 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_CHATS(
+    "chat_get_chats_select_chats",
+    "SELECT chat_id, last_event FROM chats_members, LATERAL "
+    "( "
+    " SELECT creation_timestamp FROM chats_events "
+    " WHERE chats_events.chat_id = chats_members.chat_id "
+    " ORDER BY creation_timestamp DESC "
+    " LIMIT 1 "
+    ") AS last_event "
+    "WHERE user_id = $1 "
+    "AND ($2::integer IS NULL OR type = $2) "
+    "ORDER BY event.creation_timestamp DESC");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::chat::request::GetChats& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::chat::request::GetChats& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   api::chat::response::GetChats response;
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    pqxx::params params;
-    pqxx::placeholders placeholders;
-    std::stringstream query;
-
-    query << fmt::format(
-        "SELECT chat_id, last_event FROM chats_members, LATERAL "
-        "( "
-        " SELECT creation_timestamp FROM chats_events "
-        " WHERE chats_events.chat_id = chats_members.chat_id "
-        " ORDER BY creation_timestamp DESC "
-        " LIMIT 1 "
-        ") AS last_event "
-        "WHERE user_id = {} ",
-        placeholders.view());
-
-    params.append(client.user_id()), placeholders.next();
+    std::optional<int32_t> type;
 
     if (request.filter().has_type()) {
-      query << fmt::format("AND type = {} ", placeholders.view());
-
-      params.append(std::to_underlying(request.filter().type())), placeholders.next();
+      type = std::to_underlying(request.filter().type());
     }
 
-    query << "ORDER BY event.creation_timestamp DESC";
-
-    auto result = transaction.exec_params(query.str(), params);
+    auto result = transaction.exec_prepared(SELECT_CHATS.name(), client.user_id(), type);
 
     auto* response_result = response.mutable_result();
 
@@ -68,7 +66,7 @@ std::string RequestHandler::handle(const Client& client,
     transaction.commit();
   }
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
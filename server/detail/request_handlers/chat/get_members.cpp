@@ -11,16 +11,25 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_CHAT_MEMBERS(
+    "chat_get_members_select_members",
+    "SELECT user_id, owner FROM chats_members "
+    "WHERE chat_id = $1");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::chat::request::GetMembers& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::chat::request::GetMembers& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   if (!Helpers::Chat::does_chat_exist(request.filter().chat_id())) {
     api::chat::response::GetMembers response;
@@ -29,7 +38,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::GetMembers_Error_Code_CHAT_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
   if (!Helpers::Chat::is_chat_member(request.filter().chat_id(), client.user_id())) {
     api::chat::response::GetMembers response;
@@ -38,7 +47,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::GetMembers_Error_Code_YOU_ARE_NOT_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   api::chat::response::GetMembers response;
@@ -46,12 +55,9 @@ std::string RequestHandler::handle(const Client& client,
   auto* response_result = response.mutable_result();
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params(
-        "SELECT user_id, owner FROM chats_members "
-        "WHERE chat_id = $1",
-        request.filter().chat_id());
+    auto result = transaction.exec_prepared(SELECT_CHAT_MEMBERS.name(), request.filter().chat_id());
 
     transaction.commit();
 
@@ -65,6 +71,6 @@ std::string RequestHandler::handle(const Client& client,
     }
   }
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 }  // namespace detail
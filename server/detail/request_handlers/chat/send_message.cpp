@@ -10,13 +10,12 @@
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
 #include "server_impl.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::chat::request::SendMessage& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::chat::request::SendMessage& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
@@ -30,7 +29,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::SendMessage_Error_Code_CHAT_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   auto members_user_ids = Helpers::Chat::get_chat_members(request.chat_id());
@@ -43,7 +42,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::SendMessage_Error_Code_YOU_ARE_NOT_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (Helpers::Chat::is_deleted(request.chat_id())) {
@@ -53,7 +52,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::chat::response::SendMessage_Error_Code_CHAT_IS_DELETED);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   {
@@ -66,19 +65,12 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_CHAT, chat_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    for (const auto& user_id : members_user_ids) {
-      impl.client_manager.do_for_each(user_id, do_notify);
-    }
+    impl.client_manager.broadcast(members_user_ids, Helpers::frame_event(event));
   }
 
   api::chat::response::SendMessage response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
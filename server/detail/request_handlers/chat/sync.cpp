@@ -1,8 +1,7 @@
 #include <api/chat/event.pb.h>
 #include <api/chat/request/sync.pb.h>
 #include <api/chat/response/sync.pb.h>
-#include <fmt/core.h>
-
+#include <optional>
 #include <pqxx/pqxx>
 
 #include "../../client.hpp"
@@ -12,15 +11,33 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_EVENTS(
+    "chat_sync_select_events",
+    "SELECT * FROM chats_events "
+    "WHERE chat_id = $1 AND id >= "
+    "( "
+    " SELECT first_accessible_event_id FROM chats_members "
+    " WHERE chat_id = $1 "
+    " AND user_id = $2 "
+    ") "
+    "AND ($3::bigint IS NULL OR id > $3) "
+    "ORDER BY id ASC "
+    "LIMIT $4");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client, const api::chat::request::Sync& request) {
+RequestHandler::Response RequestHandler::handle(
+    const Client& client, const api::chat::request::Sync& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   if (!Helpers::Chat::does_chat_exist(request.chat_id())) {
     api::chat::response::Sync response;
@@ -29,7 +46,7 @@ std::string RequestHandler::handle(const Client& client, const api::chat::reques
 
     response_error->set_code(api::chat::response::Sync_Error_Code_CHAT_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   if (!Helpers::Chat::is_chat_member(request.chat_id(), client.user_id())) {
@@ -39,7 +56,7 @@ std::string RequestHandler::handle(const Client& client, const api::chat::reques
 
     response_error->set_code(api::chat::response::Sync_Error_Code_YOU_ARE_NOT_MEMBER);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   api::chat::response::Sync response;
@@ -47,43 +64,16 @@ std::string RequestHandler::handle(const Client& client, const api::chat::reques
   auto* response_result = response.mutable_result();
 
   {
-    pqxx::read_transaction transaction(connection);
-
-    pqxx::params params;
-    pqxx::placeholders placeholders;
-    std::stringstream query;
-
-    query << fmt::format(
-        "SELECT * FROM chats_events "
-        "WHERE chat_id = {0} AND id >= "
-        "( "
-        " SELECT first_accessible_event_id FROM chats_members "
-        " WHERE chat_id = {0} ",
-        placeholders.view());
+    pqxx::read_transaction transaction(*connection);
 
-    params.append(request.chat_id()), placeholders.next();
-
-    query << fmt::format(
-        "AND user_id = {} "
-        ") ",
-        placeholders.view());
-
-    params.append(client.user_id()), placeholders.next();
+    std::optional<uint64_t> last_event_id;
 
     if (request.has_last_event_id()) {
-      query << fmt::format("AND id > {} ", placeholders.view());
-
-      params.append(request.last_event_id()), placeholders.next();
+      last_event_id = request.last_event_id();
     }
 
-    query << fmt::format(
-        "ORDER BY id ASC "
-        "LIMIT {}",
-        placeholders.view());
-
-    params.append(request.count()), placeholders.next();
-
-    auto result = transaction.exec_params(query.str(), params);
+    auto result = transaction.exec_prepared(SELECT_EVENTS.name(), request.chat_id(),
+                                            client.user_id(), last_event_id, request.count());
 
     transaction.commit();
 
@@ -101,7 +91,7 @@ std::string RequestHandler::handle(const Client& client, const api::chat::reques
     }
   }
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
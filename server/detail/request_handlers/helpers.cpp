@@ -14,23 +14,115 @@
 
 #include "../client.hpp"
 #include "server_impl.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement INSERT_CHAT_MEMBER(
+    "chat_add_member",
+    "INSERT INTO chats_members (chat_id, user_id, first_accessible_event_id) "
+    "VALUES ($1, $2, $3)");
+
+const DatabaseManager::Statement INSERT_CHAT_EVENT(
+    "chat_create_event",
+    "INSERT INTO chats_events (creation_timestamp, chat_id, owner_user_id, type, data) "
+    "VALUES ($1, $2, $3, $4, $5)"
+    "RETURNING id");
+
+const DatabaseManager::Statement SELECT_CHAT_EXISTS("chat_does_chat_exist",
+                                                    "SELECT true FROM CHATS WHERE id = $1");
+
+const DatabaseManager::Statement SELECT_CHAT_DELETED("chat_is_deleted",
+                                                     "SELECT deleted FROM CHATS WHERE id = $1");
+
+const DatabaseManager::Statement SELECT_CHAT_MEMBER_EXISTS(
+    "chat_is_chat_member",
+    "SELECT true FROM chats_members "
+    "WHERE chat_id = $1 AND user_id = $2");
+
+const DatabaseManager::Statement SELECT_CHAT_MEMBER_OWNER(
+    "chat_is_chat_owner",
+    "SELECT owner FROM chats_members "
+    "WHERE chat_id = $1 AND user_id = $2");
+
+const DatabaseManager::Statement SELECT_CHAT_MEMBERS(
+    "chat_get_chat_members", "SELECT user_id FROM chats_members WHERE chat_id = $1");
+
+const DatabaseManager::Statement SELECT_CHAT_TYPE("chat_get_chat_type",
+                                                  "SELECT type FROM chats WHERE id = $1");
+
+const DatabaseManager::Statement SELECT_USER_DEVICES(
+    "chat_rotate_keys_select_devices", "SELECT id FROM users_devices WHERE user_id = $1");
+
+const DatabaseManager::Statement DELETE_ONE_TIME_KEY(
+    "chat_rotate_keys_take_one_time_key",
+    "DELETE FROM users_one_time_keys "
+    "WHERE ctid = "
+    "("
+    " SELECT ctid FROM users_one_time_keys "
+    " WHERE user_id = $1 AND device_id = $2 "
+    " LIMIT 1 "
+    ") "
+    "RETURNING public_key_a, public_key_b, signature");
+
+const DatabaseManager::Statement UPDATE_PENDING_KEY_ROTATIONS(
+    "chat_rotate_keys_add_pending_key_rotation",
+    "UPDATE chats_members "
+    "SET pending_key_rotations = pending_key_rotations + 1 "
+    "WHERE chat_id = $1 AND user_id = $2");
+
+const DatabaseManager::Statement UPDATE_CHAT_OWNERS_RESET(
+    "chat_set_owner_reset",
+    "UPDATE chats_members "
+    "SET owner = false "
+    "WHERE chat_id = $1 ");
+
+const DatabaseManager::Statement UPDATE_CHAT_OWNER(
+    "chat_set_owner",
+    "UPDATE chats_members "
+    "SET owner = true "
+    "WHERE chat_id = $1 ");
+
+const DatabaseManager::Statement SELECT_USER_EXISTS("user_does_user_exist",
+                                                    "SELECT true FROM users WHERE id = $1");
+
+const DatabaseManager::Statement SELECT_CONNECTION_ESTABLISHED(
+    "user_is_connection_established",
+    "SELECT true FROM users_connections "
+    "WHERE "
+    "("
+    " (initiator_user_id = $1 AND responder_user_id = $2) "
+    " OR "
+    " (initiator_user_id = $2 AND responder_user_id = $1) "
+    ") "
+    "AND established = true "
+    "LIMIT 1");
+
+// Meant for a function-local static per helper, so timing a query does not look it up.
+metrics::Histogram& query_duration(std::string_view helper) {
+  return ServerImpl::instance().metrics_manager.histogram(
+      "neutron_database_query_duration_seconds", "Database helper latency", 1e-6,
+      {{"helper", helper}});
+}
+
+}  // namespace
+
 void RequestHandler::Helpers::Chat::add_member(uint64_t chat_id, uint64_t user_id,
                                                uint64_t first_accessible_event_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_add_member");
+
+  const auto timer = duration.time();
+
+  auto connection = impl.database_manager.connection();
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params(
-        "INSERT INTO chats_members (chat_id, user_id, first_accessible_event_id) "
-        "VALUES ($1, $2, $3)",
-        chat_id, user_id, first_accessible_event_id);
+    transaction.exec_prepared(INSERT_CHAT_MEMBER.name(), chat_id, user_id,
+                              first_accessible_event_id);
 
     transaction.commit();
   }
@@ -41,7 +133,11 @@ api::chat::Event RequestHandler::Helpers::Chat::create_event(
     const google::protobuf::Message& message) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_create_event");
+
+  const auto timer = duration.time();
+
+  auto connection = impl.database_manager.connection();
 
   auto creation_timestamp = std::chrono::duration_cast<std::chrono::seconds>(
                                 std::chrono::system_clock::now().time_since_epoch())
@@ -49,14 +145,11 @@ api::chat::Event RequestHandler::Helpers::Chat::create_event(
 
   auto data = message.SerializeAsString();
 
-  pqxx::work transaction(connection);
+  pqxx::work transaction(*connection);
 
-  auto result = transaction.exec_params1(
-      "INSERT INTO chats_events (creation_timestamp, chat_id, owner_user_id, type, data) "
-      "VALUES ($1, $2, $3, $4, $5)"
-      "RETURNING id",
-      creation_timestamp, chat_id, owner_user_id, std::to_underlying(type),
-      pqxx::binary_cast(data));
+  auto result = transaction.exec_prepared1(INSERT_CHAT_EVENT.name(), creation_timestamp, chat_id,
+                                           owner_user_id, std::to_underlying(type),
+                                           pqxx::binary_cast(data));
 
   transaction.commit();
 
@@ -79,11 +172,15 @@ api::chat::Event RequestHandler::Helpers::Chat::create_event(
 bool RequestHandler::Helpers::Chat::does_chat_exist(uint64_t chat_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_does_chat_exist");
+
+  const auto timer = duration.time();
+
+  auto connection = impl.database_manager.connection();
 
-  pqxx::read_transaction transaction(connection);
+  pqxx::read_transaction transaction(*connection);
 
-  auto result = transaction.exec_params("SELECT true FROM CHATS WHERE id = $1", chat_id);
+  auto result = transaction.exec_prepared(SELECT_CHAT_EXISTS.name(), chat_id);
 
   transaction.commit();
 
@@ -93,11 +190,15 @@ bool RequestHandler::Helpers::Chat::does_chat_exist(uint64_t chat_id) {
 bool RequestHandler::Helpers::Chat::is_deleted(uint64_t chat_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_is_deleted");
 
-  pqxx::read_transaction transaction(connection);
+  const auto timer = duration.time();
 
-  auto result = transaction.exec_params1("SELECT deleted FROM CHATS WHERE id = $1", chat_id);
+  auto connection = impl.database_manager.connection();
+
+  pqxx::read_transaction transaction(*connection);
+
+  auto result = transaction.exec_prepared1(SELECT_CHAT_DELETED.name(), chat_id);
 
   transaction.commit();
 
@@ -107,14 +208,15 @@ bool RequestHandler::Helpers::Chat::is_deleted(uint64_t chat_id) {
 bool RequestHandler::Helpers::Chat::is_chat_member(uint64_t chat_id, uint64_t user_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_is_chat_member");
+
+  const auto timer = duration.time();
 
-  pqxx::read_transaction transaction(connection);
+  auto connection = impl.database_manager.connection();
 
-  auto result = transaction.exec_params(
-      "SELECT true FROM chats_members "
-      "WHERE chat_id = $1 AND user_id = $2",
-      chat_id, user_id);
+  pqxx::read_transaction transaction(*connection);
+
+  auto result = transaction.exec_prepared(SELECT_CHAT_MEMBER_EXISTS.name(), chat_id, user_id);
 
   transaction.commit();
 
@@ -124,14 +226,15 @@ bool RequestHandler::Helpers::Chat::is_chat_member(uint64_t chat_id, uint64_t us
 bool RequestHandler::Helpers::Chat::is_chat_owner(uint64_t chat_id, uint64_t user_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_is_chat_owner");
+
+  const auto timer = duration.time();
 
-  pqxx::read_transaction transaction(connection);
+  auto connection = impl.database_manager.connection();
 
-  auto result = transaction.exec_params1(
-      "SELECT owner FROM chats_members "
-      "WHERE chat_id = $1 AND user_id = $2",
-      chat_id, user_id);
+  pqxx::read_transaction transaction(*connection);
+
+  auto result = transaction.exec_prepared1(SELECT_CHAT_MEMBER_OWNER.name(), chat_id, user_id);
 
   transaction.commit();
 
@@ -141,12 +244,15 @@ bool RequestHandler::Helpers::Chat::is_chat_owner(uint64_t chat_id, uint64_t use
 std::vector<uint64_t> RequestHandler::Helpers::Chat::get_chat_members(uint64_t chat_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_get_chat_members");
 
-  pqxx::read_transaction transaction(connection);
+  const auto timer = duration.time();
 
-  auto result =
-      transaction.exec_params("SELECT user_id FROM chats_members WHERE chat_id = $1", chat_id);
+  auto connection = impl.database_manager.connection();
+
+  pqxx::read_transaction transaction(*connection);
+
+  auto result = transaction.exec_prepared(SELECT_CHAT_MEMBERS.name(), chat_id);
 
   transaction.commit();
 
@@ -164,11 +270,15 @@ std::vector<uint64_t> RequestHandler::Helpers::Chat::get_chat_members(uint64_t c
 api::chat::Type RequestHandler::Helpers::Chat::get_chat_type(uint64_t chat_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_get_chat_type");
 
-  pqxx::read_transaction transaction(connection);
+  const auto timer = duration.time();
 
-  auto result = transaction.exec_params1("SELECT type FROM chats WHERE id = $1", chat_id);
+  auto connection = impl.database_manager.connection();
+
+  pqxx::read_transaction transaction(*connection);
+
+  auto result = transaction.exec_prepared1(SELECT_CHAT_TYPE.name(), chat_id);
 
   transaction.commit();
 
@@ -183,37 +293,27 @@ void RequestHandler::Helpers::Chat::rotate_keys(uint64_t chat_id,
                                                 const std::vector<uint64_t>& members_user_ids) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_rotate_keys");
+
+  const auto timer = duration.time();
+
+  auto connection = impl.database_manager.connection();
 
   api::chat::event::KeyRotate inner_chat_event;
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
     for (const auto& user_id : members_user_ids) {
-      auto result =
-          transaction.exec_params("SELECT id FROM users_devices WHERE user_id = $1", user_id);
+      auto result = transaction.exec_prepared(SELECT_USER_DEVICES.name(), user_id);
 
       for (const auto& row : result) {
         uint32_t device_id = row[0].as<int32_t>();
 
-        auto result = transaction.exec_params(
-            "DELETE FROM users_one_time_keys "
-            "WHERE ctid = "
-            "("
-            " SELECT ctid FROM users_one_time_keys "
-            " WHERE user_id = $1 AND device_id = $2 "
-            " LIMIT 1 "
-            ") "
-            "RETURNING public_key_a, public_key_b, signature",
-            user_id, device_id);
+        auto result = transaction.exec_prepared(DELETE_ONE_TIME_KEY.name(), user_id, device_id);
 
         if (result.empty()) {
-          transaction.exec_params(
-              "UPDATE chats_members "
-              "SET pending_key_rotations = pending_key_rotations + 1 "
-              "WHERE chat_id = $1 AND user_id = $2",
-              chat_id, user_id);
+          transaction.exec_prepared(UPDATE_PENDING_KEY_ROTATIONS.name(), chat_id, user_id);
 
           // TODO: Отправить эвент пользователю?
         } else {
@@ -241,35 +341,24 @@ void RequestHandler::Helpers::Chat::rotate_keys(uint64_t chat_id,
 
   auto event = Helpers::create_event(api::Event_Type_CHAT, chat_event);
 
-  auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-    //
-    client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-  };
-
-  for (const auto& user_id : members_user_ids) {
-    impl.client_manager.do_for_each(user_id, do_notify);
-  }
+  impl.client_manager.broadcast(members_user_ids, Helpers::frame_event(event));
 }
 
 void RequestHandler::Helpers::Chat::set_owner(uint64_t chat_id, uint64_t user_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("chat_set_owner");
+
+  const auto timer = duration.time();
+
+  auto connection = impl.database_manager.connection();
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params(
-        "UPDATE chats_members "
-        "SET owner = false "
-        "WHERE chat_id = $1 ",
-        chat_id);
+    transaction.exec_prepared(UPDATE_CHAT_OWNERS_RESET.name(), chat_id);
 
-    transaction.exec_params(
-        "UPDATE chats_members "
-        "SET owner = true "
-        "WHERE chat_id = $1 ",
-        chat_id);
+    transaction.exec_prepared(UPDATE_CHAT_OWNER.name(), chat_id);
 
     transaction.commit();
   }
@@ -300,11 +389,15 @@ api::Event RequestHandler::Helpers::User::create_event(api::user::Event_Type typ
 bool RequestHandler::Helpers::User::does_user_exist(uint64_t user_id) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("user_does_user_exist");
+
+  const auto timer = duration.time();
 
-  pqxx::read_transaction transaction(connection);
+  auto connection = impl.database_manager.connection();
 
-  auto result = transaction.exec_params("SELECT true FROM users WHERE id = $1", user_id);
+  pqxx::read_transaction transaction(*connection);
+
+  auto result = transaction.exec_prepared(SELECT_USER_EXISTS.name(), user_id);
 
   transaction.commit();
 
@@ -315,21 +408,16 @@ bool RequestHandler::Helpers::User::is_connection_established(uint64_t user_id_a
                                                               uint64_t user_id_b) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  static auto& duration = query_duration("user_is_connection_established");
+
+  const auto timer = duration.time();
 
-  pqxx::read_transaction transaction(connection);
+  auto connection = impl.database_manager.connection();
 
-  auto result = transaction.exec_params(
-      "SELECT true FROM users_connections "
-      "WHERE "
-      "("
-      " (initiator_user_id = $1 AND responder_user_id = $2) "
-      " OR "
-      " (initiator_user_id = $2 AND responder_user_id = $1) "
-      ") "
-      "AND established = true "
-      "LIMIT 1",
-      user_id_a, user_id_b);
+  pqxx::read_transaction transaction(*connection);
+
+  auto result =
+      transaction.exec_prepared(SELECT_CONNECTION_ESTABLISHED.name(), user_id_a, user_id_b);
 
   transaction.commit();
 
@@ -350,4 +438,12 @@ api::Event RequestHandler::Helpers::create_event(api::Event_Type type,
   return event;
 }
 
+communication::Server::SharedEvent RequestHandler::Helpers::frame_event(const api::Event& event) {
+  auto buffer = communication::Server::build_event(event.ByteSizeLong());
+
+  event.SerializeWithCachedSizesToArray(buffer.data().data());
+
+  return std::move(buffer).share();
+}
+
 }  // namespace detail
@@ -4,6 +4,7 @@
 #include <unordered_set>
 
 #include "../request_handler.hpp"
+#include "communication/server.hpp"
 
 namespace api {
 
@@ -73,6 +74,9 @@ struct RequestHandler::Helpers {
   };
 
   static api::Event create_event(api::Event_Type type, const google::protobuf::Message& message);
+
+  // Serialized and framed once for every client it is broadcast to.
+  static communication::Server::SharedEvent frame_event(const api::Event& event);
 };
 
 }  // namespace detail
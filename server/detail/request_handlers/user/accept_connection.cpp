@@ -12,32 +12,44 @@
 #include "../../client.hpp"
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_PENDING_CONNECTION(
+    "user_accept_connection_select_connection",
+    "SELECT true FROM users_connections "
+    "WHERE initiator_user_id = $1 AND responder_user_id = $2 AND established = false "
+    "LIMIT 1");
+
+const DatabaseManager::Statement UPDATE_CONNECTION_ESTABLISHED(
+    "user_accept_connection_establish",
+    "UPDATE users_connections "
+    "SET established = true "
+    "WHERE initiator_user_id = $1 AND responder_user_id = $2");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::AcceptConnection& request) {
+RequestHandler::Response RequestHandler::handle(
+    const Client& client, const api::user::request::AcceptConnection& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   auto initiator_user_id = request.user_id();
   auto responder_user_id = client.user_id();
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params(
-        "SELECT true FROM users_connections "
-        "WHERE initiator_user_id = $1 AND responder_user_id = $2 AND established = false "
-        "LIMIT 1",
-        initiator_user_id, responder_user_id);
+    auto result = transaction.exec_prepared(SELECT_PENDING_CONNECTION.name(), initiator_user_id,
+                                            responder_user_id);
 
     transaction.commit();
 
@@ -49,18 +61,15 @@ std::string RequestHandler::handle(const Client& client,
       response_error->set_code(
           api::user::response::AcceptConnection_Error_Code_CONNECTION_NOT_FOUND);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
   }
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    auto result = transaction.exec_params(
-        "UPDATE users_connections "
-        "SET established = true "
-        "WHERE initiator_user_id = $1 AND responder_user_id = $2",
-        initiator_user_id, responder_user_id);
+    auto result = transaction.exec_prepared(UPDATE_CONNECTION_ESTABLISHED.name(),
+                                            initiator_user_id, responder_user_id);
 
     transaction.commit();
   }
@@ -76,18 +85,13 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_USER, user_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    impl.client_manager.do_for_each(initiator_user_id, do_notify);
-    impl.client_manager.do_for_each(responder_user_id, do_notify);
+    impl.client_manager.broadcast({initiator_user_id, responder_user_id},
+                                  Helpers::frame_event(event));
   }
 
   api::user::response::AcceptConnection response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
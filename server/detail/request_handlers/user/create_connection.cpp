@@ -11,20 +11,35 @@
 #include "../../client.hpp"
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_CONNECTION_EXISTS(
+    "user_create_connection_select_connection",
+    "SELECT true FROM users_connections "
+    "WHERE (initiator_user_id = $1 AND responder_user_id = $2) OR (responder_user_id = $1 AND "
+    "initiator_user_id = $2) "
+    "LIMIT 1");
+
+const DatabaseManager::Statement INSERT_CONNECTION(
+    "user_create_connection_insert_connection",
+    "INSERT INTO users_connections (initiator_user_id, responder_user_id, established) "
+    "VALUES ($1, $2, false)");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::CreateConnection& request) {
+RequestHandler::Response RequestHandler::handle(
+    const Client& client, const api::user::request::CreateConnection& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   if (!Helpers::User::does_user_exist(request.user_id())) {
     api::user::response::CreateConnection response;
@@ -33,21 +48,17 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::CreateConnection_Error_Code_USER_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   auto initiator_user_id = client.user_id();
   auto responder_user_id = request.user_id();
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params(
-        "SELECT true FROM users_connections "
-        "WHERE (initiator_user_id = $1 AND responder_user_id = $2) OR (responder_user_id = $1 AND "
-        "initiator_user_id = $2) "
-        "LIMIT 1",
-        client.user_id(), request.user_id());
+    auto result = transaction.exec_prepared(SELECT_CONNECTION_EXISTS.name(), client.user_id(),
+                                            request.user_id());
 
     transaction.commit();
 
@@ -58,17 +69,14 @@ std::string RequestHandler::handle(const Client& client,
 
       response_error->set_code(api::user::response::CreateConnection_Error_Code_ALREADY_PENDING);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
   }
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params(
-        "INSERT INTO users_connections (initiator_user_id, responder_user_id, established) "
-        "VALUES ($1, $2, false)",
-        initiator_user_id, responder_user_id);
+    transaction.exec_prepared(INSERT_CONNECTION.name(), initiator_user_id, responder_user_id);
 
     transaction.commit();
   }
@@ -84,18 +92,13 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_USER, user_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    impl.client_manager.do_for_each(initiator_user_id, do_notify);
-    impl.client_manager.do_for_each(responder_user_id, do_notify);
+    impl.client_manager.broadcast({initiator_user_id, responder_user_id},
+                                  Helpers::frame_event(event));
   }
 
   api::user::response::CreateConnection response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
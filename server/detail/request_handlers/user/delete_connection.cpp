@@ -11,33 +11,44 @@
 #include "../../client.hpp"
 #include "../../request_handler.hpp"
 #include "../helpers.hpp"
-#include "utils/span/from.hpp"
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_CONNECTION(
+    "user_delete_connection_select_connection",
+    "SELECT initiator_user_id, responder_user_id FROM users_connections "
+    "WHERE (initiator_user_id = $1 AND responder_user_id = $2) OR (responder_user_id = $1 AND "
+    "initiator_user_id = $2) "
+    "LIMIT 1");
+
+const DatabaseManager::Statement DELETE_CONNECTION(
+    "user_delete_connection_delete_connection",
+    "DELETE FROM users_connections "
+    "WHERE initiator_user_id = $2 AND responder_user_id = $3");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::DeleteConnection& request) {
+RequestHandler::Response RequestHandler::handle(
+    const Client& client, const api::user::request::DeleteConnection& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   uint64_t _db_initiator_user_id;
   uint64_t _db_responder_user_id;
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params(
-        "SELECT initiator_user_id, responder_user_id FROM users_connections "
-        "WHERE (initiator_user_id = $1 AND responder_user_id = $2) OR (responder_user_id = $1 AND "
-        "initiator_user_id = $2) "
-        "LIMIT 1",
-        client.user_id(), request.user_id());
+    auto result =
+        transaction.exec_prepared(SELECT_CONNECTION.name(), client.user_id(), request.user_id());
 
     transaction.commit();
 
@@ -48,7 +59,7 @@ std::string RequestHandler::handle(const Client& client,
 
       response_error->set_code(api::user::response::DeleteConnection_Error_Code_NOT_FOUND);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
 
     _db_initiator_user_id = result[0]["initiator_user_id"].as<int64_t>();
@@ -56,12 +67,10 @@ std::string RequestHandler::handle(const Client& client,
   }
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params(
-        "DELETE FROM users_connections "
-        "WHERE initiator_user_id = $2 AND responder_user_id = $3",
-        _db_initiator_user_id, _db_responder_user_id);
+    transaction.exec_prepared(DELETE_CONNECTION.name(), _db_initiator_user_id,
+                              _db_responder_user_id);
 
     transaction.commit();
   }
@@ -77,18 +86,13 @@ std::string RequestHandler::handle(const Client& client,
 
     auto event = Helpers::create_event(api::Event_Type_USER, user_event);
 
-    auto do_notify = [&, event_data = event.SerializeAsString()](Client& client) {
-      //
-      client.communication().send_event({}, utils::span::from<const uint8_t>(event_data));
-    };
-
-    impl.client_manager.do_for_each(_db_initiator_user_id, do_notify);
-    impl.client_manager.do_for_each(_db_responder_user_id, do_notify);
+    impl.client_manager.broadcast({_db_initiator_user_id, _db_responder_user_id},
+                                  Helpers::frame_event(event));
   }
 
   api::user::response::DeleteConnection response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
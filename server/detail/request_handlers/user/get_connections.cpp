@@ -1,8 +1,7 @@
 #include <api/user/connection.pb.h>
 #include <api/user/request/get_connections.pb.h>
 #include <api/user/response/get_connections.pb.h>
-#include <fmt/core.h>
-
+#include <optional>
 #include <pqxx/pqxx>
 
 #include "../../../server_impl.hpp"
@@ -11,40 +10,40 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_CONNECTIONS(
+    "user_get_connections_select_connections",
+    "SELECT * FROM users_connections "
+    "WHERE (initiator_user_id = $1 OR responder_user_id = $1) "
+    "AND ($2::boolean IS NULL OR established = $2)");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::GetConnections& request) {
+RequestHandler::Response RequestHandler::handle(
+    const Client& client, const api::user::request::GetConnections& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   api::user::response::GetConnections response;
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    pqxx::params params;
-    pqxx::placeholders placeholders;
-    std::stringstream query;
-
-    query << fmt::format(
-        "SELECT * FROM users_connections "
-        "WHERE (initiator_user_id = {0} OR responder_user_id = {0}) ",
-        placeholders.view());
-
-    params.append(client.user_id()), placeholders.next();
+    std::optional<bool> established;
 
     if (request.filter().has_established()) {
-      query << fmt::format("AND established = {} ", placeholders.view());
-
-      params.append(request.filter().established()), placeholders.next();
+      established = request.filter().established();
     }
 
-    auto result = transaction.exec_params(query.str(), params);
+    auto result =
+        transaction.exec_prepared(SELECT_CONNECTIONS.name(), client.user_id(), established);
 
     transaction.commit();
 
@@ -59,7 +58,7 @@ std::string RequestHandler::handle(const Client& client,
     }
   }
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
@@ -1,8 +1,8 @@
 #include <api/user/request/get_devices.pb.h>
 #include <api/user/response/get_devices.pb.h>
-#include <fmt/core.h>
-
+#include <optional>
 #include <pqxx/pqxx>
+#include <vector>
 
 #include "../../../server_impl.hpp"
 #include "../../client.hpp"
@@ -11,16 +11,27 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_DEVICES(
+    "user_get_devices_select_devices",
+    "SELECT id, public_key FROM users_devices "
+    "WHERE user_id = $1 "
+    "AND (cardinality($2::integer[]) = 0 OR id = ANY($2)) "
+    "AND ($3::boolean IS NULL OR revoked = $3)");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::GetDevices& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::user::request::GetDevices& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   if (!Helpers::User::does_user_exist(request.filter().user_id())) {
     api::user::response::GetDevices response;
@@ -29,51 +40,43 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::GetDevices_Error_Code_USER_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   api::user::response::GetDevices response;
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    pqxx::params params;
-    pqxx::placeholders placeholders;
-    std::stringstream query;
+    std::vector<int32_t> device_ids(request.filter().device_ids().begin(),
+                                    request.filter().device_ids().end());
+    std::optional<bool> revoked;
 
-    query << fmt::format(
-        "SELECT FROM users_devices "
-        "WHERE user_id = {} ",
-        placeholders.view());
+    if (request.filter().has_revoked()) {
+      revoked = request.filter().revoked();
+    }
 
-    params.append(request.filter().user_id()), placeholders.next();
+    auto result = transaction.exec_prepared(SELECT_DEVICES.name(), request.filter().user_id(),
+                                            device_ids, revoked);
 
-    if (request.filter().device_ids_size() != 0) {
-      query << "AND id IN ( ";
+    transaction.commit();
 
-      {
-        query << fmt::format("{} ", placeholders.view());
+    auto* response_result = response.mutable_result();
 
-        params.append(request.filter().device_ids(0)), placeholders.next();
-      }
-      for (int index = 1; index < request.filter().device_ids_size(); ++index) {
-        query << fmt::format(", {} ", placeholders.view());
+    response_result->mutable_values()->Reserve(result.size());
 
-        params.append(request.filter().device_ids(index)), placeholders.next();
-      }
+    for (const auto& row : result) {
+      auto* value = response_result->add_values();
 
-      query << ") ";
-    }
-    if (request.filter().has_revoked()) {
-      query << fmt::format("AND revoked = {} ", placeholders.view());
+      value->set_id(row["id"].as<int32_t>());
+      auto _db_public_key = row["public_key"].as<std::basic_string<std::byte>>();
 
-      params.append(request.filter().revoked()), placeholders.next();
+      value->set_public_key(reinterpret_cast<const char*>(_db_public_key.data()),
+                            _db_public_key.size());
     }
-
-    transaction.commit();
   }
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
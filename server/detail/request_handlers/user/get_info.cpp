@@ -12,15 +12,15 @@
 namespace detail {
 
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::GetInfo& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::user::request::GetInfo& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   if (!Helpers::User::does_user_exist(request.user_id())) {
     api::user::response::GetInfo response;
@@ -29,7 +29,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::GetInfo_Error_Code_USER_NOT_FOUND);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   api::user::response::GetInfo response;
@@ -37,14 +37,14 @@ std::string RequestHandler::handle(const Client& client,
   // auto* response_result = response.mutable_result();
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
     //
 
     transaction.commit();
   }
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
@@ -8,8 +8,8 @@
 namespace detail {
 
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::Logout& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::user::request::Logout& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
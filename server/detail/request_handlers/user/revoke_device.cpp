@@ -8,8 +8,8 @@
 namespace detail {
 
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::RevokeDevice& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::user::request::RevokeDevice& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
@@ -11,9 +11,26 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_USER(
+    "user_sign_in_select_user",
+    "SELECT id, encoded_password FROM users WHERE username = $1 LIMIT 1");
+
+const DatabaseManager::Statement SELECT_DEVICE_EXISTS(
+    "user_sign_in_select_device", "SELECT true FROM users_devices WHERE user_id = $1 AND id = $2");
+
+const DatabaseManager::Statement INSERT_DEVICE(
+    "user_sign_in_insert_device",
+    "INSERT INTO users_devices (user_id, public_key) "
+    "VALUES ($1, $2) "
+    "RETURNING id");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::SignIn& request) {
+RequestHandler::Response RequestHandler::handle(const Client& client,
+                                                 const api::user::request::SignIn& request) {
   if (client.is_authorized()) {
     api::user::response::SignIn response;
 
@@ -21,7 +38,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::SignIn_Error_Code_ALREADY_SIGNED_IN);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   uint64_t user_id;
@@ -29,13 +46,12 @@ std::string RequestHandler::handle(const Client& client,
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params(
-        "SELECT id, encoded_password FROM users WHERE username = $1 LIMIT 1", request.username());
+    auto result = transaction.exec_prepared(SELECT_USER.name(), request.username());
 
     transaction.commit();
 
@@ -46,7 +62,7 @@ std::string RequestHandler::handle(const Client& client,
 
       response_error->set_code(api::user::response::SignIn_Error_Code_USER_NOT_FOUND);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
 
     auto encoded_password = result[0]["encoded_password"].view();
@@ -58,17 +74,16 @@ std::string RequestHandler::handle(const Client& client,
 
       response_error->set_code(api::user::response::SignIn_Error_Code_INVALID_PASSWORD);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
 
     user_id = result[0]["id"].as<int64_t>();
   }
 
   if (request.has_device_id()) {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params(
-        "SELECT true FROM users_devices WHERE user_id = $1 AND id = $2", user_id, device_id);
+    auto result = transaction.exec_prepared(SELECT_DEVICE_EXISTS.name(), user_id, device_id);
 
     transaction.commit();
 
@@ -79,7 +94,7 @@ std::string RequestHandler::handle(const Client& client,
 
       response_error->set_code(api::user::response::SignIn_Error_Code_DEVICE_NOT_FOUND);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
 
     device_id = request.device_id();
@@ -91,16 +106,13 @@ std::string RequestHandler::handle(const Client& client,
 
       response_error->set_code(api::user::response::SignIn_Error_Code_INVALID_PUBLIC_KEY);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
 
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    auto result = transaction.exec_params1(
-        "INSERT INTO users_devices (user_id, public_key) "
-        "VALUES ($1, $2) "
-        "RETURNING id",
-        user_id, pqxx::binary_cast(request.device_public_key()));
+    auto result = transaction.exec_prepared1(INSERT_DEVICE.name(), user_id,
+                                             pqxx::binary_cast(request.device_public_key()));
 
     transaction.commit();
 
@@ -115,7 +127,7 @@ std::string RequestHandler::handle(const Client& client,
 
   response_result->set_device_id(device_id);
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
@@ -9,17 +9,28 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_USERNAME_TAKEN(
+    "user_sign_up_select_user", "SELECT true FROM users WHERE username = $1 LIMIT 1");
+
+const DatabaseManager::Statement INSERT_USER(
+    "user_sign_up_insert_user",
+    "INSERT INTO users (username, encoded_password) "
+    "VALUES ($1, $2)");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const api::user::request::SignUp& request) {
+RequestHandler::Response RequestHandler::handle(const api::user::request::SignUp& request) {
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params("SELECT true FROM users WHERE username = $1 LIMIT 1",
-                                          request.username());
+    auto result = transaction.exec_prepared(SELECT_USERNAME_TAKEN.name(), request.username());
 
     transaction.commit();
 
@@ -30,7 +41,7 @@ std::string RequestHandler::handle(const api::user::request::SignUp& request) {
 
       response_error->set_code(api::user::response::SignUp_Error_Code_USERNAME_TAKEN);
 
-      return response.SerializeAsString();
+      return serialize(response);
     }
   }
 
@@ -41,19 +52,16 @@ std::string RequestHandler::handle(const api::user::request::SignUp& request) {
       crypto::Argon2::hash(request.password(), crypto::Argon2::Type::id, configuration);
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params(
-        "INSERT INTO users (username, encoded_password) "
-        "VALUES ($1, $2)",
-        request.username(), encoded_password);
+    transaction.exec_prepared(INSERT_USER.name(), request.username(), encoded_password);
 
     transaction.commit();
   }
 
   api::user::response::SignUp response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
@@ -14,27 +14,51 @@
 
 namespace detail {
 
+namespace {
+
+const DatabaseManager::Statement SELECT_DEVICE_PUBLIC_KEY(
+    "user_upload_one_time_key_select_device",
+    "SELECT public_key FROM users_devices "
+    "WHERE user_id = $1 AND id = $2 "
+    "LIMIT 1");
+
+const DatabaseManager::Statement INSERT_ONE_TIME_KEY(
+    "user_upload_one_time_key_insert_key",
+    "INSERT INTO users_one_time_keys (user_id, device_id, public_key_a, public_key_b, "
+    "signature) "
+    "VALUES ($1, $2, $3, $4, $5)");
+
+const DatabaseManager::Statement UPDATE_PENDING_KEY_ROTATIONS(
+    "user_upload_one_time_key_take_pending_key_rotation",
+    "UPDATE chats_members "
+    "SET pending_key_rotations = pending_key_rotations - 1 "
+    "WHERE ctid = "
+    "( "
+    " SELECT ctid FROM chats_members "
+    " WHERE user_id = $1 AND pending_key_rotations > 0 "
+    ") "
+    "RETURNING chat_id");
+
+}  // namespace
+
 template <>
-std::string RequestHandler::handle(const Client& client,
-                                   const api::user::request::UploadOneTimeKey& request) {
+RequestHandler::Response RequestHandler::handle(
+    const Client& client, const api::user::request::UploadOneTimeKey& request) {
   if (!client.is_authorized()) {
     throw UnauthorizedException();
   }
 
   auto& impl = ServerImpl::instance();
 
-  auto& connection = impl.database_manager.connection();
+  auto connection = impl.database_manager.connection();
 
   std::array<uint8_t, crypto::Falcon512::PublicKeyLength> public_key;
 
   {
-    pqxx::read_transaction transaction(connection);
+    pqxx::read_transaction transaction(*connection);
 
-    auto result = transaction.exec_params1(
-        "SELECT public_key FROM users_devices "
-        "WHERE user_id = $1 AND id = $2 "
-        "LIMIT 1",
-        client.user_id(), client.device_id());
+    auto result = transaction.exec_prepared1(SELECT_DEVICE_PUBLIC_KEY.name(), client.user_id(),
+                                             client.device_id());
 
     transaction.commit();
 
@@ -52,7 +76,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::UploadOneTimeKey_Error_Code_INVALID_PUBLIC_KEY_A);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
   if (one_time_key.public_key_b().size() != crypto::SIDHp434_compressed::PublicKeyLength) {
     api::user::response::UploadOneTimeKey response;
@@ -61,7 +85,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::UploadOneTimeKey_Error_Code_INVALID_PUBLIC_KEY_B);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
   if (one_time_key.signature().size() != crypto::Falcon512::SignatureLength) {
     api::user::response::UploadOneTimeKey response;
@@ -70,7 +94,7 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::UploadOneTimeKey_Error_Code_INVALID_SIGNATURE);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   std::array<uint8_t, crypto::SIDHp434_compressed::PublicKeyLength> xored_one_time_public_key;
@@ -87,35 +111,24 @@ std::string RequestHandler::handle(const Client& client,
 
     response_error->set_code(api::user::response::UploadOneTimeKey_Error_Code_INVALID_SIGNATURE);
 
-    return response.SerializeAsString();
+    return serialize(response);
   }
 
   {
-    pqxx::work transaction(connection);
+    pqxx::work transaction(*connection);
 
-    transaction.exec_params(
-        "INSERT INTO users_one_time_keys (user_id, device_id, public_key_a, public_key_b, "
-        "signature) "
-        "VALUES ($1, $2, $3, $4, $5)",
-        client.user_id(), client.device_id(), pqxx::binary_cast(one_time_key.public_key_a()),
-        pqxx::binary_cast(one_time_key.public_key_b()),
-        pqxx::binary_cast(one_time_key.signature()));
+    transaction.exec_prepared(INSERT_ONE_TIME_KEY.name(), client.user_id(), client.device_id(),
+                              pqxx::binary_cast(one_time_key.public_key_a()),
+                              pqxx::binary_cast(one_time_key.public_key_b()),
+                              pqxx::binary_cast(one_time_key.signature()));
 
     transaction.commit();
   }
 
   {
-    pqxx::work transaction(connection);
-
-    auto result = transaction.exec_params(
-        "UPDATE chats_members "
-        "SET pending_key_rotations = pending_key_rotations - 1 "
-        "WHERE ctid = "
-        "( "
-        " SELECT ctid FROM chats_members "
-        " WHERE user_id = $1 AND pending_key_rotations > 0 "
-        ") "
-        "RETURNING chat_id");
+    pqxx::work transaction(*connection);
+
+    auto result = transaction.exec_prepared(UPDATE_PENDING_KEY_ROTATIONS.name(), client.user_id());
 
     transaction.commit();
 
@@ -128,7 +141,7 @@ std::string RequestHandler::handle(const Client& client,
 
   api::user::response::UploadOneTimeKey response;
 
-  return response.SerializeAsString();
+  return serialize(response);
 }
 
 }  // namespace detail
@@ -0,0 +1,68 @@
+#include "request_limits.hpp"
+
+#include "utils/debug/assert.hpp"
+
+namespace detail {
+
+RequestLimits::RequestLimits() : RequestLimits(0, 0, 0) {}
+
+RequestLimits::RequestLimits(size_t max_queued_requests, size_t max_requests_per_client,
+                             size_t max_requests_per_user)
+    : max_queued_requests_(max_queued_requests),
+      max_requests_per_client_(max_requests_per_client),
+      max_requests_per_user_(max_requests_per_user),
+      queued_requests_(0) {}
+
+std::optional<RequestLimits::Limit> RequestLimits::acquire(uint64_t client_id,
+                                                           std::optional<uint64_t> user_id) {
+  if (queued_requests_ >= max_queued_requests_) [[unlikely]] {
+    return Limit::Server;
+  }
+
+  if (auto requests = client_requests_.find(client_id);
+      requests != client_requests_.end() && requests->second >= max_requests_per_client_)
+      [[unlikely]] {
+    return Limit::Client;
+  }
+
+  if (user_id.has_value()) {
+    if (auto requests = user_requests_.find(*user_id);
+        requests != user_requests_.end() && requests->second >= max_requests_per_user_)
+        [[unlikely]] {
+      return Limit::User;
+    }
+
+    ++user_requests_[*user_id];
+  }
+
+  ++client_requests_[client_id];
+  ++queued_requests_;
+
+  return std::nullopt;
+}
+
+void RequestLimits::release(uint64_t client_id, std::optional<uint64_t> user_id) {
+  ASSERT(queued_requests_ != 0);
+
+  --queued_requests_;
+
+  auto client_requests = client_requests_.find(client_id);
+
+  ASSERT(client_requests != client_requests_.end());
+
+  if (--client_requests->second == 0) {
+    client_requests_.erase(client_requests);
+  }
+
+  if (user_id.has_value()) {
+    auto user_requests = user_requests_.find(*user_id);
+
+    ASSERT(user_requests != user_requests_.end());
+
+    if (--user_requests->second == 0) {
+      user_requests_.erase(user_requests);
+    }
+  }
+}
+
+}  // namespace detail
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace detail {
+
+// Requests queued or being executed, counted server wide, per client and per user of the client.
+// A request is only admitted while all of them stay within their limits. Not synchronized, the
+// RequestScheduler holds its own lock around it.
+class RequestLimits {
+ public:
+  enum class Limit : size_t { Client, Server, User };
+
+  static constexpr size_t LIMITS = 3;
+
+ public:
+  // Every limit is 0, so nothing is admitted.
+  RequestLimits();
+  RequestLimits(size_t max_queued_requests, size_t max_requests_per_client,
+                size_t max_requests_per_user);
+
+  // Counts the request against every limit, unless it would exceed one, then returns that limit
+  // and counts nothing.
+  [[nodiscard]] std::optional<Limit> acquire(uint64_t client_id, std::optional<uint64_t> user_id);
+
+  // Uncounts a request admitted by acquire() with the same client and user.
+  void release(uint64_t client_id, std::optional<uint64_t> user_id);
+
+ private:
+  size_t max_queued_requests_;
+  size_t max_requests_per_client_;
+  size_t max_requests_per_user_;
+
+  size_t queued_requests_;
+  std::unordered_map<uint64_t, size_t> client_requests_;
+  std::unordered_map<uint64_t, size_t> user_requests_;
+};
+
+}  // namespace detail
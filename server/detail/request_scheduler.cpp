@@ -0,0 +1,187 @@
+#include "request_scheduler.hpp"
+
+#include <api/chat/request.pb.h>
+#include <api/request.pb.h>
+#include <api/user/request.pb.h>
+#include <fmt/format.h>
+
+#include <stdexcept>
+#include <string_view>
+
+#include "server_impl.hpp"
+
+namespace detail {
+
+namespace {
+
+constexpr std::string_view LANE_NAMES[] = {"interactive", "bulk"};
+constexpr std::string_view LIMIT_NAMES[] = {"client", "server", "user"};
+
+// Parses "<group>.<type>", e.g. "user.GET_INFO", into the api::Request type and the type of the
+// request it wraps.
+std::optional<std::pair<int, int>> parse_request_type(std::string_view name) {
+  const auto separator = name.find('.');
+
+  if (separator == std::string_view::npos) {
+    return std::nullopt;
+  }
+
+  const auto group = name.substr(0, separator);
+  const std::string type(name.substr(separator + 1));
+
+  if (group == "chat") {
+    if (api::chat::Request_Type value; api::chat::Request_Type_Parse(type, &value)) {
+      return std::make_pair(static_cast<int>(api::Request_Type_CHAT), static_cast<int>(value));
+    }
+  } else if (group == "user") {
+    if (api::user::Request_Type value; api::user::Request_Type_Parse(type, &value)) {
+      return std::make_pair(static_cast<int>(api::Request_Type_USER), static_cast<int>(value));
+    }
+  }
+
+  return std::nullopt;
+}
+
+}  // namespace
+
+RequestScheduler::RequestScheduler() : shed_requests_{} {}
+
+RequestScheduler::~RequestScheduler() = default;
+
+void RequestScheduler::configure(Configuration&& configuration) {
+  ASSERT(configuration.max_queued_requests != 0);
+  ASSERT(configuration.max_requests_per_client != 0);
+  ASSERT(configuration.max_requests_per_user != 0);
+
+  for (const auto& name : configuration.bulk_requests) {
+    auto request_type = parse_request_type(name);
+
+    if (!request_type.has_value()) [[unlikely]] {
+      throw std::runtime_error(fmt::format("Unknown request type {}", name));
+    }
+
+    request_lanes_[*request_type] = Lane::Bulk;
+  }
+
+  limits_ = RequestLimits(configuration.max_queued_requests, configuration.max_requests_per_client,
+                          configuration.max_requests_per_user);
+
+  auto& metrics_manager = ServerImpl::instance().metrics_manager;
+
+  for (size_t i = 0; i < LANES; ++i) {
+    lanes_[i].queued_requests_gauge =
+        &metrics_manager.gauge("neutron_scheduled_requests", "Requests queued or being executed",
+                               {{"lane", LANE_NAMES[i]}});
+  }
+
+  constexpr std::string_view SHED_HELP = "Requests answered with TOO_MANY_REQUESTS";
+
+  for (size_t i = 0; i < RequestLimits::LIMITS; ++i) {
+    shed_requests_[i] = &metrics_manager.counter("neutron_shed_requests_total", SHED_HELP,
+                                                 {{"limit", LIMIT_NAMES[i]}});
+  }
+}
+
+size_t RequestScheduler::pool(Lane lane) { return static_cast<size_t>(lane); }
+
+bool RequestScheduler::schedule(std::shared_ptr<Client> client, size_t request_identifier,
+                                communication::Payload&& data) {
+  ASSERT(shed_requests_[0] != nullptr);
+
+  const auto client_id = client->id();
+  const auto lane = classify(data);
+
+  const auto user_id = ServerImpl::instance().client_manager.user_id(client_id);
+
+  std::lock_guard lock(mutex_);
+
+  if (auto limit = limits_.acquire(client_id, user_id)) [[unlikely]] {
+    shed_requests_[static_cast<size_t>(*limit)]->add();
+
+    return false;
+  }
+
+  auto& lane_state = lanes_[static_cast<size_t>(lane)];
+
+  lane_state.queued_requests_gauge->add();
+
+  const auto size = data.size();
+
+  if (lane_state.requests.push(
+          client_id, {std::move(client), request_identifier, std::move(data), user_id}, size)) {
+    activate(lane);
+  }
+
+  return true;
+}
+
+RequestScheduler::Lane RequestScheduler::classify(std::span<const uint8_t> data) const {
+  // Malformed requests are rejected right away, they are as cheap as anything interactive.
+  if (auto request_type = RequestHandler::peek_type(data)) {
+    if (auto lane = request_lanes_.find(*request_type); lane != request_lanes_.end()) {
+      return lane->second;
+    }
+  }
+
+  return Lane::Interactive;
+}
+
+void RequestScheduler::execute_next_request(Lane lane) {
+  auto& lane_state = lanes_[static_cast<size_t>(lane)];
+
+  std::optional<Request> request;
+  uint64_t client_id;
+
+  {
+    std::lock_guard lock(mutex_);
+
+    auto next = lane_state.requests.pop();
+
+    client_id = next.first;
+    request.emplace(std::move(next.second));
+  }
+
+  // The request is accounted for as done however handling it ends, or the client, its user and
+  // the whole server would be left over their limits for good.
+  struct Completion {
+    ~Completion() {
+      const auto user_id = request->user_id;
+
+      request.reset();
+
+      scheduler.complete(lane, client_id, user_id);
+    }
+
+    RequestScheduler& scheduler;
+    Lane lane;
+    uint64_t client_id;
+    std::optional<Request>& request;
+  } completion{*this, lane, client_id, request};
+
+  // Requests of a client that has gone away meanwhile have no one to answer to. It may still go
+  // away while the request is executed, the handler does not answer then.
+  if (request->client->communication().is_open()) [[likely]] {
+    ServerImpl::instance().request_handler.handle(*request->client, request->identifier,
+                                                  request->data);
+  }
+}
+
+void RequestScheduler::complete(Lane lane, uint64_t client_id, std::optional<uint64_t> user_id) {
+  auto& lane_state = lanes_[static_cast<size_t>(lane)];
+
+  std::lock_guard lock(mutex_);
+
+  limits_.release(client_id, user_id);
+  lane_state.queued_requests_gauge->sub();
+
+  if (lane_state.requests.complete(client_id)) {
+    activate(lane);
+  }
+}
+
+void RequestScheduler::activate(Lane lane) {
+  ServerImpl::instance().worker_manager.post(pool(lane),
+                                             [this, lane]() { execute_next_request(lane); });
+}
+
+}  // namespace detail
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "communication/server.hpp"
+#include "fair_queue.hpp"
+#include "metrics.hpp"
+#include "request_limits.hpp"
+
+namespace detail {
+
+class Client;
+
+// Decides which request a free worker executes next. Every client has its own queue and the
+// clients with work are served by deficit round robin, weighted by request size, so a client
+// pipelining large requests cannot starve the others. Past the per client, per user or server
+// wide limit requests are shed instead of queued.
+//
+// Requests are split into lanes by type, each with its own rounds and its own worker pool, so
+// latency critical requests never wait behind bulk reads. Within a lane requests of a client are
+// executed one at a time, in the order they arrived.
+class RequestScheduler {
+ public:
+  enum class Lane : size_t { Interactive, Bulk };
+
+  static constexpr size_t LANES = 2;
+
+  struct Configuration {
+    // Request types served in the bulk lane, e.g. "user.GET_CONNECTIONS", the rest are
+    // interactive.
+    std::vector<std::string> bulk_requests;
+    size_t max_queued_requests;
+    size_t max_requests_per_client;
+    size_t max_requests_per_user;
+  };
+
+ public:
+  RequestScheduler();
+  ~RequestScheduler();
+
+  // Throws std::runtime_error on an unknown request type.
+  void configure(Configuration&& configuration);
+
+  // The worker pool of a lane is the pool with the index of the lane.
+  [[nodiscard]] static size_t pool(Lane lane);
+
+  // Queues the request, returns false when it is shed, then the caller answers it.
+  [[nodiscard]] bool schedule(std::shared_ptr<Client> client, size_t request_identifier,
+                              communication::Payload&& data);
+
+ private:
+  struct Request {
+    std::shared_ptr<Client> client;
+    size_t identifier;
+    communication::Payload data;
+    // The user the request was counted against, the client may sign in or out meanwhile.
+    std::optional<uint64_t> user_id;
+  };
+
+  struct LaneState {
+    // A flow per client.
+    FairQueue<Request> requests;
+
+    metrics::Gauge* queued_requests_gauge = nullptr;
+  };
+
+ private:
+  [[nodiscard]] Lane classify(std::span<const uint8_t> data) const;
+
+  // Executes the request of the flow at the head of the round of the lane, posted once per flow
+  // that becomes runnable.
+  void execute_next_request(Lane lane);
+
+  // Releases what an executed request of the flow held against the limits and puts the flow back
+  // in the round if it has more.
+  void complete(Lane lane, uint64_t client_id, std::optional<uint64_t> user_id);
+
+  // Wakes a worker of the lane for a flow that joined its round.
+  void activate(Lane lane);
+
+ private:
+  // Keyed by api::Request type and the type of the request it wraps.
+  std::map<std::pair<int, int>, Lane> request_lanes_;
+
+  std::mutex mutex_;
+  std::array<LaneState, LANES> lanes_;
+  RequestLimits limits_;
+
+  // Indexed by the limit a request was shed at.
+  std::array<metrics::Counter*, RequestLimits::LIMITS> shed_requests_;
+};
+
+}  // namespace detail
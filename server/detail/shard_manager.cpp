@@ -0,0 +1,92 @@
+#include "shard_manager.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "utils/debug/assert.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace detail {
+
+namespace {
+
+void pin(std::thread& thread, size_t core) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+
+  if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0) {
+    spdlog::warn("Failed to pin shard thread to core {}", core);
+  }
+#else
+  (void)thread;
+  (void)core;
+#endif
+}
+
+}  // namespace
+
+ShardManager::Shard::Shard(asio::io_context& io_context)
+    : io_context(io_context), work_guard(asio::make_work_guard(io_context)) {}
+
+ShardManager::ShardManager(asio::io_context& io_context) : io_context_(io_context) {}
+
+ShardManager::~ShardManager() = default;
+
+void ShardManager::configure(size_t num_shards) {
+  ASSERT(shards_.empty());
+  ASSERT(num_shards != 0);
+
+  shards_.reserve(num_shards);
+  shards_.emplace_back(io_context_);
+
+  // Every other shard is only ever run by its own thread.
+  for (size_t i = 1; i < num_shards; ++i) {
+    shards_.emplace_back(*owned_io_contexts_.emplace_back(std::make_unique<asio::io_context>(1)));
+  }
+}
+
+std::vector<std::reference_wrapper<asio::io_context>> ShardManager::io_contexts() const {
+  std::vector<std::reference_wrapper<asio::io_context>> result;
+
+  result.reserve(shards_.size());
+
+  for (const auto& shard : shards_) {
+    result.emplace_back(shard.io_context);
+  }
+
+  return result;
+}
+
+void ShardManager::run() {
+  const size_t num_cores = std::max(std::thread::hardware_concurrency(), 1u);
+
+  std::vector<std::thread> threads;
+
+  threads.reserve(shards_.size());
+
+  for (size_t i = 0; i < shards_.size(); ++i) {
+    threads.emplace_back([this, i]() { shards_[i].io_context.run(); });
+
+    pin(threads.back(), i % num_cores);
+  }
+
+  std::for_each(threads.begin(), threads.end(), [](std::thread& thread) { thread.join(); });
+}
+
+size_t ShardManager::size() const { return shards_.size(); }
+
+void ShardManager::stop() {
+  for (auto& shard : shards_) {
+    shard.work_guard.reset();
+    shard.io_context.stop();
+  }
+}
+
+}  // namespace detail
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace detail {
+
+// Thread-per-core runtime: one io_context per shard, each run by a single thread pinned to its
+// own core. Shard 0 is the server io_context, which also carries the listening socket and the
+// metrics endpoint. Connections, and the clients built on them, are placed on a shard when
+// accepted and never leave it; work for another shard is posted to it rather than run under a
+// shared lock.
+class ShardManager {
+ public:
+  explicit ShardManager(asio::io_context& io_context);
+  ~ShardManager();
+
+  // Creates the remaining shards, must be called before anything is placed on them.
+  void configure(size_t num_shards);
+
+  [[nodiscard]] std::vector<std::reference_wrapper<asio::io_context>> io_contexts() const;
+
+  // Runs every shard on its own thread and returns once all of them have stopped.
+  void run();
+
+  [[nodiscard]] size_t size() const;
+
+  // Stops every shard, handlers still queued are dropped. Safe to call from any thread.
+  void stop();
+
+ private:
+  struct Shard {
+    explicit Shard(asio::io_context& io_context);
+
+    asio::io_context& io_context;
+    asio::executor_work_guard<asio::io_context::executor_type> work_guard;
+  };
+
+ private:
+  asio::io_context& io_context_;
+
+  std::vector<std::unique_ptr<asio::io_context>> owned_io_contexts_;
+  std::vector<Shard> shards_;
+};
+
+}  // namespace detail
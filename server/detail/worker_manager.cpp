@@ -0,0 +1,45 @@
+#include "worker_manager.hpp"
+
+#include <string>
+
+#include "server_impl.hpp"
+
+namespace detail {
+
+thread_local size_t WorkerManager::current_pool_ = 0;
+
+WorkerManager::WorkerManager() : num_workers_(0) {}
+
+WorkerManager::~WorkerManager() = default;
+
+void WorkerManager::configure(const std::vector<size_t>& pool_sizes) {
+  ASSERT(pools_.empty());
+  ASSERT(!pool_sizes.empty());
+
+  pools_.reserve(pool_sizes.size());
+
+  for (size_t i = 0; i < pool_sizes.size(); ++i) {
+    ASSERT(pool_sizes[i] != 0);
+
+    pools_.emplace_back(std::make_unique<asio::thread_pool>(pool_sizes[i]),
+                        &ServerImpl::instance().metrics_manager.gauge(
+                            "neutron_worker_pending_jobs", "Requests waiting for a worker",
+                            {{"pool", std::to_string(i)}}));
+
+    num_workers_ += pool_sizes[i];
+  }
+}
+
+size_t WorkerManager::current_pool() { return current_pool_; }
+
+size_t WorkerManager::size() const { return num_workers_; }
+
+void WorkerManager::stop() {
+  for (auto& [thread_pool, pending_jobs] : pools_) {
+    thread_pool->join();
+  }
+
+  pools_.clear();
+}
+
+}  // namespace detail
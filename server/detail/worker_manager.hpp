@@ -0,0 +1,60 @@
+#pragma once
+
+#include <asio/post.hpp>
+#include <asio/thread_pool.hpp>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "metrics.hpp"
+#include "utils/debug/assert.hpp"
+
+namespace detail {
+
+// Pools of worker threads requests are executed on, away from the shards, so a slow database
+// round trip never holds up packet processing, acknowledgements or timers. Pools are separate so
+// one kind of work cannot take the threads of another. A pool queue is not bounded by itself, the
+// RequestScheduler posts one job per client with a runnable request.
+class WorkerManager {
+ public:
+  WorkerManager();
+  ~WorkerManager();
+
+  // Starts the workers of every pool, must be called before anything is posted.
+  void configure(const std::vector<size_t>& pool_sizes);
+
+  template <typename Job>
+  void post(size_t pool, Job&& job) {
+    ASSERT(pool < pools_.size());
+
+    auto& [thread_pool, pending_jobs] = pools_[pool];
+
+    pending_jobs->add();
+
+    asio::post(*thread_pool,
+               [pool, pending_jobs = pending_jobs, job = std::forward<Job>(job)]() mutable {
+                 pending_jobs->sub();
+
+                 current_pool_ = pool;
+
+                 job();
+               });
+  }
+
+  // Pool of the calling worker, 0 on any other thread.
+  [[nodiscard]] static size_t current_pool();
+
+  // Number of workers of all pools together.
+  [[nodiscard]] size_t size() const;
+
+  // Waits for the jobs already posted and stops the workers.
+  void stop();
+
+ private:
+  std::vector<std::pair<std::unique_ptr<asio::thread_pool>, metrics::Gauge*>> pools_;
+  size_t num_workers_;
+
+  static thread_local size_t current_pool_;
+};
+
+}  // namespace detail
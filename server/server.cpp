@@ -1,6 +1,10 @@
 #include <spdlog/spdlog.h>
 #include <toml++/toml.h>
 
+#include <asio/ip/tcp.hpp>
+#include <asio/local/stream_protocol.hpp>
+#include <asio/signal_set.hpp>
+#include <csignal>
 #include <cxxopts.hpp>
 #include <fstream>
 #include <iostream>
@@ -66,8 +70,6 @@ void Server::start(int argc, char* argv[]) {
 
   impl.database_manager.create_tables();
 
-  impl.database_manager.connection().close();
-
   protocol::Server::Configuration server_configuration;
 
   if (auto* address = config_parse_result["address"].as_string()) {
@@ -88,6 +90,32 @@ void Server::start(int argc, char* argv[]) {
     server_configuration.backlog = 0;
   }
 
+  if (auto handshake_rate = config_parse_result["handshake_rate"].value<double>()) {
+    protocol::Server::HandshakeRateLimit handshake_rate_limit;
+
+    // The burst defaults to a second worth of handshakes, but never less than one.
+    handshake_rate_limit.burst = std::max(
+        config_parse_result["handshake_burst"].value<double>().value_or(*handshake_rate), 1.0);
+    handshake_rate_limit.rate = *handshake_rate;
+
+    if (auto prefix_length = config_parse_result["handshake_ipv4_prefix_length"].value<uint8_t>()) {
+      handshake_rate_limit.ipv4_prefix_length = *prefix_length;
+    }
+    if (auto prefix_length = config_parse_result["handshake_ipv6_prefix_length"].value<uint8_t>()) {
+      handshake_rate_limit.ipv6_prefix_length = *prefix_length;
+    }
+
+    server_configuration.handshake_rate_limit = handshake_rate_limit;
+  }
+
+  if (auto* hibernation_interval = config_parse_result["hibernation_interval"].as_integer()) {
+    server_configuration.hibernation_interval =
+        std::chrono::milliseconds(hibernation_interval->get());
+  }
+
+  server_configuration.max_concurrent_handshakes =
+      config_parse_result["max_concurrent_handshakes"].value<size_t>();
+
   server_configuration.receive_buffer_size =
       config_parse_result["receive_buffer_size"].value<unsigned>();
 
@@ -130,16 +158,92 @@ void Server::start(int argc, char* argv[]) {
 
   server_configuration.secret_key = std::move(secret_key);
 
+  // One shard per thread, connections are spread over them as they are accepted.
+  impl.shard_manager.configure(std::max(
+      config_parse_result["num_threads"].value_or<unsigned>(std::thread::hardware_concurrency()),
+      1u));
+
+  server_configuration.connection_io_contexts = impl.shard_manager.io_contexts();
+
+  // Past any of these limits requests are answered with TOO_MANY_REQUESTS instead of queued.
+  RequestScheduler::Configuration request_scheduler_configuration{
+      {"user.GET_CONNECTIONS", "user.GET_INFO"},
+      std::max(config_parse_result["max_queued_requests"].value_or<size_t>(16384), size_t(1)),
+      std::max(config_parse_result["max_requests_per_client"].value_or<size_t>(64), size_t(1)),
+      std::max(config_parse_result["max_requests_per_user"].value_or<size_t>(256), size_t(1))};
+
+  if (auto* bulk_requests = config_parse_result["bulk_requests"].as_array()) {
+    request_scheduler_configuration.bulk_requests.clear();
+
+    for (const auto& bulk_request : *bulk_requests) {
+      if (auto name = bulk_request.value<std::string>()) {
+        request_scheduler_configuration.bulk_requests.push_back(std::move(*name));
+      }
+    }
+  }
+
+  try {
+    impl.request_scheduler.configure(std::move(request_scheduler_configuration));
+  } catch (const std::runtime_error& error) {
+    spdlog::error("Invalid bulk_requests: {}", error.what());
+    return;
+  }
+
+  // Requests are executed off the shards, in a pool per lane of the request scheduler.
+  const auto num_workers = std::max(
+      config_parse_result["num_workers"].value_or<unsigned>(std::thread::hardware_concurrency()),
+      1u);
+  const auto num_bulk_workers =
+      std::max(config_parse_result["num_bulk_workers"].value_or<unsigned>(num_workers / 4), 1u);
+
+  std::vector<size_t> pool_sizes(RequestScheduler::LANES);
+
+  pool_sizes[RequestScheduler::pool(RequestScheduler::Lane::Interactive)] = num_workers;
+  pool_sizes[RequestScheduler::pool(RequestScheduler::Lane::Bulk)] = num_bulk_workers;
+
+  impl.worker_manager.configure(pool_sizes);
+
+  // A database connection pool per worker pool, a worker waits when all of its pool are in use.
+  pool_sizes[RequestScheduler::pool(RequestScheduler::Lane::Interactive)] = std::max(
+      config_parse_result["database_connections"].value_or<unsigned>(num_workers), 1u);
+  pool_sizes[RequestScheduler::pool(RequestScheduler::Lane::Bulk)] = std::max(
+      config_parse_result["database_bulk_connections"].value_or<unsigned>(num_bulk_workers), 1u);
+
+  impl.database_manager.configure(pool_sizes);
+
   impl.network_manager.start_accept(std::move(server_configuration));
 
-  std::vector<std::thread> threads;
-  std::generate_n(
-      std::back_inserter(threads),
-      config_parse_result["num_threads"].value_or<unsigned>(std::thread::hardware_concurrency()),
-      [&]() { return std::thread([&]() { impl.io_context.run(); }); });
-  std::for_each(threads.begin(), threads.end(), [](std::thread& thread) { thread.join(); });
+  // Served on a local socket only, either a UNIX socket or a loopback TCP port by default.
+  if (auto* metrics_socket = config_parse_result["metrics_socket"].as_string()) {
+    std::filesystem::remove(metrics_socket->get());
+
+    impl.metrics_manager.start({asio::local::stream_protocol::endpoint(metrics_socket->get())},
+                               impl.shard_manager.io_contexts());
+  } else if (auto* metrics_port = config_parse_result["metrics_port"].as_integer()) {
+    auto metrics_address = asio::ip::make_address(
+        config_parse_result["metrics_address"].value_or<std::string>("127.0.0.1"));
+
+    impl.metrics_manager.start({asio::ip::tcp::endpoint(metrics_address, metrics_port->get())},
+                               impl.shard_manager.io_contexts());
+  }
+
+  asio::signal_set signals(impl.io_context, SIGINT, SIGTERM);
+
+  signals.async_wait([&impl](const asio::error_code& error, [[maybe_unused]] int signal) {
+    if (error) {
+      return;
+    }
+
+    impl.network_manager.stop_accept();
+    impl.shard_manager.stop();
+  });
+
+  impl.shard_manager.run();
+
+  impl.worker_manager.stop();
 }
 
-ServerImpl::ServerImpl(Token) : network_manager(io_context) {}
+ServerImpl::ServerImpl(Token)
+    : metrics_manager(io_context), network_manager(io_context), shard_manager(io_context) {}
 
 ServerImpl::~ServerImpl() = default;
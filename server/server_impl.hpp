@@ -4,9 +4,13 @@
 
 #include "detail/client_manager.hpp"
 #include "detail/database_manager.hpp"
+#include "detail/metrics_manager.hpp"
 #include "detail/network_manager.hpp"
 #include "detail/path_manager.hpp"
 #include "detail/request_handler.hpp"
+#include "detail/request_scheduler.hpp"
+#include "detail/shard_manager.hpp"
+#include "detail/worker_manager.hpp"
 #include "server.hpp"
 #include "utils/singleton.hpp"
 
@@ -22,9 +26,13 @@ class ServerImpl : public utils::Singleton<ServerImpl> {
 
   ClientManager client_manager;
   DatabaseManager database_manager;
+  MetricsManager metrics_manager;
   NetworkManager network_manager;
   PathManager path_manager;
   RequestHandler request_handler;
+  RequestScheduler request_scheduler;
+  ShardManager shard_manager;
+  WorkerManager worker_manager;
 };
 
 }  // namespace detail
@@ -1,47 +1,22 @@
 #include <boost/ut.hpp>
 #include <vector>
 
+#include "aead_vectors.hpp"
 #include "crypto/chacha20poly1305.hpp"
 
 int main() {
-  auto expected_plaintext = std::vector<uint8_t>{
-      0x4c, 0x61, 0x64, 0x69, 0x65, 0x73, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x47, 0x65, 0x6e, 0x74,
-      0x6c, 0x65, 0x6d, 0x65, 0x6e, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x6c,
-      0x61, 0x73, 0x73, 0x20, 0x6f, 0x66, 0x20, 0x27, 0x39, 0x39, 0x3a, 0x20, 0x49, 0x66, 0x20,
-      0x49, 0x20, 0x63, 0x6f, 0x75, 0x6c, 0x64, 0x20, 0x6f, 0x66, 0x66, 0x65, 0x72, 0x20, 0x79,
-      0x6f, 0x75, 0x20, 0x6f, 0x6e, 0x6c, 0x79, 0x20, 0x6f, 0x6e, 0x65, 0x20, 0x74, 0x69, 0x70,
-      0x20, 0x66, 0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x75, 0x74, 0x75, 0x72, 0x65,
-      0x2c, 0x20, 0x73, 0x75, 0x6e, 0x73, 0x63, 0x72, 0x65, 0x65, 0x6e, 0x20, 0x77, 0x6f, 0x75,
-      0x6c, 0x64, 0x20, 0x62, 0x65, 0x20, 0x69, 0x74, 0x2e};
-  auto aad =
-      std::vector<uint8_t>{0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
-  auto key = std::vector<uint8_t>{0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a,
-                                  0x8b, 0x8c, 0x8d, 0x8e, 0x8f, 0x90, 0x91, 0x92, 0x93, 0x94, 0x95,
-                                  0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f};
-  auto iv =
-      std::vector<uint8_t>{0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b,
-                           0x4c, 0x4d, 0x4e, 0x4f, 0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57};
-  auto expected_ciphertext = std::vector<uint8_t>{
-      0xbd, 0x6d, 0x17, 0x9d, 0x3e, 0x83, 0xd4, 0x3b, 0x95, 0x76, 0x57, 0x94, 0x93, 0xc0, 0xe9,
-      0x39, 0x57, 0x2a, 0x17, 0x00, 0x25, 0x2b, 0xfa, 0xcc, 0xbe, 0xd2, 0x90, 0x2c, 0x21, 0x39,
-      0x6c, 0xbb, 0x73, 0x1c, 0x7f, 0x1b, 0x0b, 0x4a, 0xa6, 0x44, 0x0b, 0xf3, 0xa8, 0x2f, 0x4e,
-      0xda, 0x7e, 0x39, 0xae, 0x64, 0xc6, 0x70, 0x8c, 0x54, 0xc2, 0x16, 0xcb, 0x96, 0xb7, 0x2e,
-      0x12, 0x13, 0xb4, 0x52, 0x2f, 0x8c, 0x9b, 0xa4, 0x0d, 0xb5, 0xd9, 0x45, 0xb1, 0x1b, 0x69,
-      0xb9, 0x82, 0xc1, 0xbb, 0x9e, 0x3f, 0x3f, 0xac, 0x2b, 0xc3, 0x69, 0x48, 0x8f, 0x76, 0xb2,
-      0x38, 0x35, 0x65, 0xd3, 0xff, 0xf9, 0x21, 0xf9, 0x66, 0x4c, 0x97, 0x63, 0x7d, 0xa9, 0x76,
-      0x88, 0x12, 0xf6, 0x15, 0xc6, 0x8b, 0x13, 0xb5, 0x2e};
-  auto expected_tag = std::vector<uint8_t>{0xc0, 0x87, 0x59, 0x24, 0xc1, 0xc7, 0x98, 0x79,
-                                           0x47, 0xde, 0xaf, 0xd8, 0x78, 0x0a, 0xcf, 0x49};
+  using v = vectors::xchacha20poly1305;
 
-  std::vector<uint8_t> ciphertext(expected_ciphertext.size());
-  std::vector<uint8_t> tag(expected_tag.size());
-  std::vector<uint8_t> plaintext(expected_plaintext.size());
+  std::vector<uint8_t> ciphertext(v::ciphertext.size());
+  std::vector<uint8_t> tag(v::tag.size());
+  std::vector<uint8_t> plaintext(v::plaintext.size());
 
-  crypto::XChaCha20Poly1305::encrypt(ciphertext, tag, iv, key, aad, expected_plaintext);
-  boost::ut::expect(ciphertext == expected_ciphertext);
-  boost::ut::expect(tag == expected_tag);
-  boost::ut::expect(crypto::XChaCha20Poly1305::decrypt(plaintext, tag, iv, key, aad, ciphertext));
-  boost::ut::expect(plaintext == expected_plaintext);
+  crypto::XChaCha20Poly1305::encrypt(ciphertext, tag, v::iv, v::key, v::aad, v::plaintext);
+  boost::ut::expect(ciphertext == v::ciphertext);
+  boost::ut::expect(tag == v::tag);
+  boost::ut::expect(
+      crypto::XChaCha20Poly1305::decrypt(plaintext, tag, v::iv, v::key, v::aad, ciphertext));
+  boost::ut::expect(plaintext == v::plaintext);
 
   return 0;
 }
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "protocol/detail/datagram_pool.hpp"
+
+using protocol::detail::DatagramPool;
+using protocol::detail::DatagramSlice;
+
+int main() {
+  // Copies and sub-slices share the block, it is back in the pool once the last one is gone.
+  {
+    const auto in_use = DatagramPool::statistics().in_use;
+
+    {
+      auto datagram = DatagramSlice::allocate(100);
+
+      boost::ut::expect(datagram.size() == 100);
+      boost::ut::expect(DatagramPool::statistics().in_use == in_use + 1);
+
+      std::fill_n(datagram.data(), datagram.size(), 0xAB);
+
+      auto copy = datagram;
+      auto part = datagram.slice({datagram.data() + 10, 20});
+
+      boost::ut::expect(copy.data() == datagram.data());
+      boost::ut::expect(part.data() == datagram.data() + 10 && part.size() == 20);
+      boost::ut::expect(DatagramPool::statistics().in_use == in_use + 1);
+
+      datagram = DatagramSlice();
+      copy = DatagramSlice();
+
+      boost::ut::expect(DatagramPool::statistics().in_use == in_use + 1);
+      boost::ut::expect(std::all_of(part.data(), part.data() + part.size(),
+                                    [](uint8_t byte) { return byte == 0xAB; }));
+
+      auto moved = std::move(part);
+
+      boost::ut::expect(part.empty() && moved.size() == 20);
+    }
+
+    boost::ut::expect(DatagramPool::statistics().in_use == in_use);
+  }
+
+  // A released block is reused by the next allocation of the thread.
+  {
+    const uint8_t* data;
+
+    {
+      auto datagram = DatagramSlice::allocate(DatagramPool::BLOCK_SIZE);
+
+      data = datagram.data();
+    }
+
+    const auto misses = DatagramPool::statistics().misses;
+
+    auto datagram = DatagramSlice::allocate(64);
+
+    boost::ut::expect(datagram.data() == data);
+    boost::ut::expect(DatagramPool::statistics().misses == misses);
+
+    datagram.shrink(10);
+
+    boost::ut::expect(datagram.size() == 10);
+  }
+
+  // Datagrams larger than a block are served on their own and counted as misses.
+  {
+    const auto statistics = DatagramPool::statistics();
+
+    {
+      auto datagram = DatagramSlice::allocate(DatagramPool::BLOCK_SIZE + 1);
+
+      boost::ut::expect(datagram.size() == DatagramPool::BLOCK_SIZE + 1);
+      boost::ut::expect(DatagramPool::statistics().misses == statistics.misses + 1);
+    }
+
+    boost::ut::expect(DatagramPool::statistics().in_use == statistics.in_use);
+  }
+
+  // A copy holds the bytes in a block of its own, not a pooled one.
+  {
+    std::vector<uint8_t> bytes(300);
+
+    for (size_t i = 0; i < bytes.size(); ++i) {
+      bytes[i] = static_cast<uint8_t>(i);
+    }
+
+    const auto statistics = DatagramPool::statistics();
+
+    {
+      auto copy = DatagramSlice::copy(bytes);
+
+      boost::ut::expect(std::equal(bytes.begin(), bytes.end(), copy.data(),
+                                   copy.data() + copy.size()));
+      boost::ut::expect(DatagramPool::statistics().misses == statistics.misses);
+    }
+
+    boost::ut::expect(DatagramPool::statistics().in_use == statistics.in_use);
+    boost::ut::expect(DatagramPool::statistics().slabs == statistics.slabs);
+  }
+
+  // Unless it fills a whole block, then it is a pooled one and goes back to the pool.
+  {
+    const std::vector<uint8_t> bytes(DatagramPool::BLOCK_SIZE, 0x5A);
+
+    const uint8_t* data;
+
+    {
+      auto copy = DatagramSlice::copy(bytes);
+
+      boost::ut::expect(std::equal(bytes.begin(), bytes.end(), copy.data(),
+                                   copy.data() + copy.size()));
+
+      data = copy.data();
+    }
+
+    auto datagram = DatagramSlice::allocate(DatagramPool::BLOCK_SIZE);
+
+    boost::ut::expect(datagram.data() == data);
+  }
+
+  // The high-water mark follows the most blocks in use at once.
+  {
+    std::vector<DatagramSlice> datagrams;
+
+    const auto in_use = DatagramPool::statistics().in_use;
+
+    for (size_t i = 0; i < 200; ++i) {
+      datagrams.push_back(DatagramSlice::allocate(1000));
+    }
+
+    boost::ut::expect(DatagramPool::statistics().high_water_mark >= in_use + 200);
+
+    datagrams.clear();
+
+    boost::ut::expect(DatagramPool::statistics().in_use == in_use);
+  }
+
+  return 0;
+}
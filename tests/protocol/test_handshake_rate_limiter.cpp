@@ -0,0 +1,56 @@
+#include <asio/ip/address.hpp>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <thread>
+
+#include "protocol/detail/server/handshake_rate_limiter.hpp"
+
+using protocol::detail::HandshakeRateLimiter;
+
+int main() {
+  // A burst is admitted at once, the rest of it is refused until tokens are refilled.
+  {
+    HandshakeRateLimiter limiter({3, 24, 48, 0.001});
+
+    const auto address = asio::ip::make_address("192.0.2.1");
+
+    boost::ut::expect(limiter.try_acquire(address));
+    boost::ut::expect(limiter.try_acquire(address));
+    boost::ut::expect(limiter.try_acquire(address));
+    boost::ut::expect(!limiter.try_acquire(address));
+
+    // Addresses of a prefix share its budget, other prefixes have their own.
+    boost::ut::expect(!limiter.try_acquire(asio::ip::make_address("192.0.2.200")));
+    boost::ut::expect(limiter.try_acquire(asio::ip::make_address("192.0.3.1")));
+    boost::ut::expect(limiter.try_acquire(asio::ip::make_address("2001:db8::1")));
+
+    // A v4-mapped v6 address is the same source as the v4 one.
+    boost::ut::expect(!limiter.try_acquire(asio::ip::make_address("::ffff:192.0.2.1")));
+  }
+
+  // IPv6 sources are limited per prefix as well.
+  {
+    HandshakeRateLimiter limiter({1, 32, 48, 0.001});
+
+    boost::ut::expect(limiter.try_acquire(asio::ip::make_address("2001:db8:1::1")));
+    boost::ut::expect(!limiter.try_acquire(asio::ip::make_address("2001:db8:1:ffff::2")));
+    boost::ut::expect(limiter.try_acquire(asio::ip::make_address("2001:db8:2::1")));
+  }
+
+  // Tokens are refilled at the rate, up to the burst.
+  {
+    HandshakeRateLimiter limiter({1, 32, 64, 100});
+
+    const auto address = asio::ip::make_address("198.51.100.1");
+
+    boost::ut::expect(limiter.try_acquire(address));
+    boost::ut::expect(!limiter.try_acquire(address));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    boost::ut::expect(limiter.try_acquire(address));
+    boost::ut::expect(!limiter.try_acquire(address));
+  }
+
+  return 0;
+}
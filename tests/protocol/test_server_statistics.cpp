@@ -0,0 +1,102 @@
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/ip/udp.hpp>
+#include <boost/ut.hpp>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "crypto/sidhp434_compressed.hpp"
+#include "protocol/connection.hpp"
+#include "protocol/server.hpp"
+
+namespace {
+
+// Polls until predicate holds, returns false on timeout.
+template <typename Predicate>
+bool wait_for(Predicate&& predicate) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+  while (!predicate()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  std::vector<uint8_t> public_key(crypto::SIDHp434_compressed::PublicKeyLength);
+  std::vector<uint8_t> secret_key(crypto::SIDHp434_compressed::SecretKeyBLength);
+
+  crypto::SIDHp434_compressed::generate_keypair_B(public_key, secret_key);
+
+  asio::io_context io_context;
+  auto work_guard = asio::make_work_guard(io_context);
+
+  std::thread thread([&io_context]() { io_context.run(); });
+
+  protocol::Server server(io_context);
+
+  protocol::Server::Configuration config;
+  config.backlog = 1;
+  config.local_endpoint = {asio::ip::address_v4::loopback(), 0};
+  config.secret_key = std::move(secret_key);
+
+  server.open(std::move(config));
+
+  auto client = std::make_shared<protocol::Connection>(io_context);
+
+  {
+    auto socket = std::make_shared<asio::generic::datagram_protocol::socket>(
+        asio::ip::udp::socket(io_context, {asio::ip::address_v4::loopback(), 0}));
+
+    protocol::Connection::ClientConfiguration config;
+    config.rx_socket = socket;
+    config.tx_socket = socket;
+    config.peer_endpoint = server.local_endpoint();
+    config.peer_public_key = public_key;
+
+    client->associate(std::move(config));
+  }
+
+  boost::ut::expect(wait_for([&server]() { return server.has_pending_connections(); }));
+
+  // The server keeps counting a connection after handing it out.
+  auto accepted = server.next_pending_connection();
+
+  boost::ut::expect(accepted != nullptr);
+
+  const auto live = server.statistics();
+
+  boost::ut::expect(live.connections == 1);
+  boost::ut::expect(live.transport.packets_received != 0);
+  boost::ut::expect(live.transport.packets_sent != 0);
+
+  // And once it is closed its counters are kept in the totals.
+  accepted->abort();
+
+  boost::ut::expect(wait_for([&server]() { return server.statistics().connections == 0; }));
+
+  const auto closed = server.statistics();
+
+  boost::ut::expect(closed.transport.packets_received >= live.transport.packets_received);
+  boost::ut::expect(closed.transport.packets_sent >= live.transport.packets_sent);
+  boost::ut::expect(closed.transport.bytes_received >= live.transport.bytes_received);
+  boost::ut::expect(closed.transport.bytes_sent >= live.transport.bytes_sent);
+
+  accepted.reset();
+  client->abort();
+  server.close();
+
+  work_guard.reset();
+  io_context.stop();
+  thread.join();
+
+  return 0;
+}
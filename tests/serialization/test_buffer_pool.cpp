@@ -0,0 +1,64 @@
+#include <boost/ut.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "serialization/buffer_pool.hpp"
+
+int main() {
+  // Acquired buffers have the requested size and are zero-filled.
+  {
+    auto buffer = serialization::BufferPool::acquire(100);
+
+    boost::ut::expect(buffer.size() == 100);
+    boost::ut::expect(buffer.capacity() >= 128);
+    boost::ut::expect(buffer == std::vector<uint8_t>(100, 0));
+
+    boost::ut::expect(serialization::BufferPool::acquire(0).empty());
+  }
+
+  // A released buffer is handed out again for a size of the same class, none of the bytes of its
+  // previous owner left, however much shorter or longer it is.
+  {
+    auto buffer = serialization::BufferPool::acquire(1000);
+
+    buffer.assign(buffer.size(), 0xFF);
+
+    const auto* data = buffer.data();
+
+    serialization::BufferPool::release(std::move(buffer));
+
+    auto reused = serialization::BufferPool::acquire(600);
+
+    boost::ut::expect(reused.data() == data);
+    boost::ut::expect(reused == std::vector<uint8_t>(600, 0));
+
+    reused.assign(reused.size(), 0xFF);
+
+    serialization::BufferPool::release(std::move(reused));
+
+    auto longer = serialization::BufferPool::acquire(1024);
+
+    boost::ut::expect(longer.data() == data);
+    boost::ut::expect(longer == std::vector<uint8_t>(1024, 0));
+
+    serialization::BufferPool::release(std::move(longer));
+
+    // Not for a larger class, which its capacity could not hold.
+    auto larger = serialization::BufferPool::acquire(1500);
+
+    boost::ut::expect(larger.data() != data);
+    boost::ut::expect(larger.size() == 1500);
+  }
+
+  // Sizes past the largest class are served, just not pooled.
+  {
+    auto large = serialization::BufferPool::acquire(size_t(1) << 20);
+
+    boost::ut::expect(large.size() == size_t(1) << 20);
+
+    serialization::BufferPool::release(std::move(large));
+  }
+
+  return 0;
+}
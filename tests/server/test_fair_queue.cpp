@@ -0,0 +1,111 @@
+#include <boost/ut.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "detail/fair_queue.hpp"
+
+int main() {
+  using Queue = detail::FairQueue<int>;
+
+  // A flow joins the round with its first item and leaves it once it has none left.
+  {
+    Queue queue;
+
+    boost::ut::expect(queue.push(1, 10, 0));
+    boost::ut::expect(!queue.push(1, 11, 0));
+
+    auto [flow_id, item] = queue.pop();
+    boost::ut::expect(flow_id == 1 && item == 10);
+
+    // Not while its item is executing either.
+    boost::ut::expect(!queue.push(1, 12, 0));
+    boost::ut::expect(queue.complete(1));
+
+    boost::ut::expect(queue.pop().second == 11);
+    boost::ut::expect(queue.complete(1));
+    boost::ut::expect(queue.pop().second == 12);
+    boost::ut::expect(!queue.complete(1));
+
+    boost::ut::expect(queue.push(1, 13, 0));
+  }
+
+  // The items of a flow are executed one at a time, meanwhile the other flows are served.
+  {
+    Queue queue;
+
+    boost::ut::expect(queue.push(1, 10, 0));
+    boost::ut::expect(!queue.push(1, 11, 0));
+    boost::ut::expect(queue.push(2, 20, 0));
+
+    boost::ut::expect(queue.pop().second == 10);
+    boost::ut::expect(queue.pop().second == 20);
+    boost::ut::expect(!queue.complete(2));
+    boost::ut::expect(queue.complete(1));
+    boost::ut::expect(queue.pop().second == 11);
+  }
+
+  // Flows of small items take turns, whichever flow queued the most.
+  {
+    Queue queue;
+
+    for (int i = 0; i < 8; ++i) {
+      (void)queue.push(1, int(i), 0);
+    }
+    for (int i = 0; i < 2; ++i) {
+      (void)queue.push(2, int(i), 0);
+      (void)queue.push(3, int(i), 0);
+    }
+
+    std::vector<uint64_t> order;
+
+    for (int i = 0; i < 6; ++i) {
+      auto [flow_id, item] = queue.pop();
+
+      order.push_back(flow_id);
+
+      (void)queue.complete(flow_id);
+    }
+
+    boost::ut::expect(order == std::vector<uint64_t>{1, 2, 3, 1, 2, 3});
+  }
+
+  // A flow of large items gets as many bytes as a flow of small ones rather than as many items.
+  {
+    constexpr size_t LARGE_SIZE = 4 * Queue::QUANTUM - Queue::ITEM_BASE_COST;
+    constexpr size_t SMALL_SIZE = Queue::QUANTUM - Queue::ITEM_BASE_COST;
+
+    Queue queue;
+
+    for (int i = 0; i < 4; ++i) {
+      (void)queue.push(1, int(i), LARGE_SIZE);
+    }
+    for (int i = 0; i < 32; ++i) {
+      (void)queue.push(2, int(i), SMALL_SIZE);
+    }
+
+    std::map<uint64_t, size_t> executed;
+
+    while (executed[1] != 4) {
+      auto [flow_id, item] = queue.pop();
+
+      ++executed[flow_id];
+
+      (void)queue.complete(flow_id);
+    }
+
+    boost::ut::expect(executed[2] >= 4 * 3 && executed[2] <= 4 * 4);
+  }
+
+  // Items only need to be movable.
+  {
+    detail::FairQueue<std::unique_ptr<int>> queue;
+
+    boost::ut::expect(queue.push(1, std::make_unique<int>(10), 0));
+    boost::ut::expect(*queue.pop().second == 10);
+    boost::ut::expect(!queue.complete(1));
+  }
+
+  return 0;
+}
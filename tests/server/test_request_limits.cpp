@@ -0,0 +1,54 @@
+#include <boost/ut.hpp>
+#include <optional>
+
+#include "detail/request_limits.hpp"
+
+int main() {
+  using Limit = detail::RequestLimits::Limit;
+
+  // Nothing is admitted until the limits are configured.
+  {
+    detail::RequestLimits limits;
+
+    boost::ut::expect(limits.acquire(1, std::nullopt) == Limit::Server);
+  }
+
+  detail::RequestLimits limits(5, 2, 3);
+
+  // Per client.
+  boost::ut::expect(!limits.acquire(1, std::nullopt).has_value());
+  boost::ut::expect(!limits.acquire(1, std::nullopt).has_value());
+  boost::ut::expect(limits.acquire(1, std::nullopt) == Limit::Client);
+
+  // Per user, across the clients it is signed in on.
+  boost::ut::expect(!limits.acquire(2, 7).has_value());
+  boost::ut::expect(!limits.acquire(3, 7).has_value());
+  boost::ut::expect(!limits.acquire(4, 7).has_value());
+
+  // Server wide, checked first.
+  boost::ut::expect(limits.acquire(5, std::nullopt) == Limit::Server);
+  boost::ut::expect(limits.acquire(5, 7) == Limit::Server);
+
+  limits.release(1, std::nullopt);
+
+  boost::ut::expect(limits.acquire(5, 7) == Limit::User);
+  boost::ut::expect(limits.acquire(5, 8) == std::nullopt);
+
+  // Shed requests were not counted, releasing the admitted ones frees exactly their share.
+  limits.release(2, 7);
+
+  boost::ut::expect(!limits.acquire(6, 7).has_value());
+  boost::ut::expect(limits.acquire(6, 7) == Limit::Server);
+
+  limits.release(1, std::nullopt);
+  limits.release(3, 7);
+  limits.release(4, 7);
+  limits.release(5, 8);
+  limits.release(6, 7);
+
+  for (int i = 0; i < 5; ++i) {
+    boost::ut::expect(!limits.acquire(10 + i, 9 + (i % 2)).has_value());
+  }
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+#include <boost/ut.hpp>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "utils/mpsc_queue.hpp"
+
+int main() {
+  // First in, first out.
+  {
+    utils::MpscQueue<int> queue;
+
+    boost::ut::expect(!queue.pop().has_value());
+
+    queue.push(1);
+    queue.push(2);
+
+    boost::ut::expect(queue.pop() == 1);
+
+    queue.push(3);
+
+    boost::ut::expect(queue.pop() == 2);
+    boost::ut::expect(queue.pop() == 3);
+    boost::ut::expect(!queue.pop().has_value());
+  }
+
+  // Values left in the queue are destroyed with it.
+  {
+    auto value = std::make_shared<int>(1);
+
+    {
+      utils::MpscQueue<std::shared_ptr<int>> queue;
+
+      queue.push(value);
+      queue.push(value);
+
+      boost::ut::expect(value.use_count() == 3);
+    }
+
+    boost::ut::expect(value.use_count() == 1);
+  }
+
+  // Concurrent producers, every value arrives once and those of a producer arrive in order.
+  {
+    constexpr size_t PRODUCERS = 4;
+    constexpr uint32_t VALUES_PER_PRODUCER = 100000;
+
+    utils::MpscQueue<uint64_t> queue;
+
+    std::vector<std::thread> producers;
+
+    for (size_t producer = 0; producer < PRODUCERS; ++producer) {
+      producers.emplace_back([&queue, producer]() {
+        for (uint32_t i = 0; i < VALUES_PER_PRODUCER; ++i) {
+          queue.push((uint64_t(producer) << 32) | i);
+        }
+      });
+    }
+
+    std::vector<uint32_t> next_values(PRODUCERS, 0);
+    bool in_order = true;
+
+    for (size_t received = 0; received < PRODUCERS * VALUES_PER_PRODUCER;) {
+      if (auto value = queue.pop()) {
+        const auto producer = *value >> 32;
+        const auto i = static_cast<uint32_t>(*value);
+
+        in_order = in_order && producer < PRODUCERS && i == next_values[producer];
+
+        if (producer < PRODUCERS) {
+          ++next_values[producer];
+        }
+
+        ++received;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+
+    for (auto& producer : producers) {
+      producer.join();
+    }
+
+    boost::ut::expect(in_order);
+    boost::ut::expect(!queue.pop().has_value());
+  }
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <array>
+#include <boost/ut.hpp>
+#include <memory>
+#include <utility>
+
+#include "utils/small_function.hpp"
+
+int main() {
+  using Function = utils::SmallFunction<int(int)>;
+
+  // Empty until assigned a callable.
+  {
+    Function function;
+
+    boost::ut::expect(!function);
+    boost::ut::expect(function == nullptr);
+
+    function = [](int value) { return value + 1; };
+
+    boost::ut::expect(static_cast<bool>(function));
+    boost::ut::expect(function(1) == 2);
+
+    function = nullptr;
+
+    boost::ut::expect(!function);
+  }
+
+  // Captures are destroyed exactly once, whether stored inline or on the heap, and moving the
+  // function leaves the source empty.
+  {
+    auto counter = std::make_shared<int>(0);
+
+    {
+      Function small = [counter](int value) { return *counter += value; };
+      Function large = [counter, padding = std::array<char, 256>{}](int value) {
+        return *counter += value + padding[0];
+      };
+
+      boost::ut::expect(counter.use_count() == 3);
+
+      boost::ut::expect(small(1) == 1);
+      boost::ut::expect(large(2) == 3);
+
+      Function moved_small(std::move(small));
+      Function moved_large;
+
+      moved_large = std::move(large);
+
+      boost::ut::expect(!small && !large);
+      boost::ut::expect(counter.use_count() == 3);
+
+      boost::ut::expect(moved_small(1) == 4);
+      boost::ut::expect(moved_large(1) == 5);
+
+      moved_small = std::move(moved_large);
+
+      boost::ut::expect(counter.use_count() == 2);
+      boost::ut::expect(moved_small(1) == 6);
+    }
+
+    boost::ut::expect(counter.use_count() == 1);
+  }
+
+  // Move-only callables, and arguments forwarded without copies.
+  {
+    utils::SmallFunction<int(std::unique_ptr<int>)> function =
+        [offset = std::make_unique<int>(1)](std::unique_ptr<int> value) {
+          return *value + *offset;
+        };
+
+    boost::ut::expect(function(std::make_unique<int>(2)) == 3);
+  }
+
+  return 0;
+}